@@ -15,8 +15,11 @@ enum SubdeviceType : uint8_t {
   SUBDEVICE_PIXELS = 4,
 };
 
+static constexpr uint8_t SUBDEVICE_TYPE_COUNT = 5;
+
 enum StepperDriverType : uint8_t {
   STEPPER_DRIVER_GENERIC = 0,
+  STEPPER_DRIVER_STEP_DIR = 1,
 };
 
 enum StepperSeekMode : uint8_t {
@@ -43,7 +46,42 @@ enum PixelDriverType : uint8_t {
   PIXEL_DRIVER_GENERIC = 0,
 };
 
-static constexpr uint8_t MAX_SUBDEVICES = 12;
+// Solid: 3 slots (RGB) color the whole strip. Mapped: 3 slots per pixel from the start
+// address on, continuing into the following universes (170 pixels per universe, a pixel is
+// never split across two universes).
+enum PixelMode : uint8_t {
+  PIXEL_MODE_SOLID = 0,
+  PIXEL_MODE_MAPPED = 1,
+  PIXEL_MODE_EFFECT = 2,
+};
+
+static constexpr uint16_t MAX_PIXELS_PER_STRIP = 1024;
+
+// Byte order on the wire, first to last (WS2812B is GRB).
+enum PixelColorOrder : uint8_t {
+  PIXEL_ORDER_GRB = 0,
+  PIXEL_ORDER_RGB = 1,
+  PIXEL_ORDER_BRG = 2,
+  PIXEL_ORDER_RBG = 3,
+  PIXEL_ORDER_GBR = 4,
+  PIXEL_ORDER_BGR = 5,
+};
+
+// Each subdevice config carries only its own type's payload and runtime state comes from
+// per-type pools (core/subdevices.cpp), so a subdevice entry itself costs little RAM.
+#if defined(ESP8266)
+static constexpr uint8_t MAX_SUBDEVICES = 16;
+#else
+static constexpr uint8_t MAX_SUBDEVICES = 64;
+#endif
+// Distinct sACN/Art-Net universes the receivers join and buffer frames for. Frame buffers are
+// only allocated for configured universes; on ESP32 the cap covers eight 512-pixel mapped
+// strips (4 universes each) plus the other subdevices.
+#if defined(ESP8266)
+static constexpr uint8_t MAX_UNIVERSES = 12;
+#else
+static constexpr uint8_t MAX_UNIVERSES = 40;
+#endif
 
 struct SacnMapping {
   uint16_t universe = 1;
@@ -56,12 +94,20 @@ struct StepperRuntimeConfig {
   uint8_t in2 = 17;
   uint8_t in3 = 18;
   uint8_t in4 = 19;
+  // STEP/DIR driver: enable is active low (255 = not wired); stepsPerRev counts full
+  // steps and is multiplied by the driver's microstep setting.
+  uint8_t stepPin = 25;
+  uint8_t dirPin = 26;
+  uint8_t enablePin = 255;
+  uint16_t microsteps = 1;
   uint16_t stepsPerRev = 4096;
   float maxDegPerSec = 90.0f;
-  bool limitsEnabled = false;
+  float accelDegPerSec2 = 0.0f; // 0 = jump straight to speed
+  float jerkDegPerSec3 = 0.0f;  // 0 = trapezoidal ramp, otherwise S-curve
   float minDeg = 0.0f;
   float maxDeg = 360.0f;
   int32_t homeOffsetSteps = 0;
+  bool limitsEnabled = false;
   bool homeSwitchEnabled = false;
   uint8_t homeSwitchPin = 255;
   bool homeSwitchActiveLow = true;
@@ -70,7 +116,6 @@ struct StepperRuntimeConfig {
   StepperDirection seekForwardDirection = STEPPER_DIR_CW;
   StepperDirection seekReturnDirection = STEPPER_DIR_CCW;
   StepperTieBreakMode seekTieBreakMode = STEPPER_TIEBREAK_OPPOSITE_LAST;
-  bool seekClockwise = true; // legacy config fallback
 };
 
 struct DcMotorRuntimeConfig {
@@ -79,10 +124,10 @@ struct DcMotorRuntimeConfig {
   uint8_t pwmPin = 27;
   uint8_t pwmChannel = 0;
   uint32_t pwmHz = 500;
-  uint8_t pwmBits = 8;
   int16_t deadband = 900;
-  uint8_t maxPwm = 255;
   uint16_t rampBufferMs = 120;
+  uint8_t pwmBits = 8;
+  uint8_t maxPwm = 255;
   bool command16Bit = false;
 };
 
@@ -98,23 +143,35 @@ struct LedRuntimeConfig {
 
 struct PixelRuntimeConfig {
   PixelDriverType driver = PIXEL_DRIVER_GENERIC;
+  PixelMode mode = PIXEL_MODE_SOLID;
+  PixelColorOrder colorOrder = PIXEL_ORDER_GRB;
   uint8_t pin = 26;
   uint16_t count = 30;
   uint8_t brightness = 50;
+  // 1.0 = linear.
+  float gamma = 1.0f;
 };
 
+// Tagged union: `type` selects the one live payload member. Change the type through
+// setSubdeviceType() so the new payload starts from its defaults.
 struct SubdeviceConfig {
+  SubdeviceConfig() : stepper() {}
+
   bool enabled = true;
   char name[24] = "subdevice";
   SubdeviceType type = SUBDEVICE_STEPPER;
   SacnMapping map;
-  StepperRuntimeConfig stepper;
-  DcMotorRuntimeConfig dc;
-  RelayRuntimeConfig relay;
-  LedRuntimeConfig led;
-  PixelRuntimeConfig pixels;
+  union {
+    StepperRuntimeConfig stepper;
+    DcMotorRuntimeConfig dc;
+    RelayRuntimeConfig relay;
+    LedRuntimeConfig led;
+    PixelRuntimeConfig pixels;
+  };
 };
 
+void setSubdeviceType(SubdeviceConfig& sd, SubdeviceType type);
+
 struct AppConfig {
   String ssid;
   String pass;
@@ -129,11 +186,15 @@ struct AppConfig {
   uint16_t startAddr = 1;
   SacnMode sacnMode = SACN_UNICAST;
   uint16_t sacnBufferMs = 0;
+  uint16_t artnetUniverseOffset = 1; // sACN universe = Art-Net port-address + offset
 
   DmxLossMode lossMode = LOSS_FORCE_OFF;
   uint32_t lossTimeoutMs = 1000;
 
   uint8_t homeButtonPin = 23;
+  // Pixels reserved at boot beyond the configured strips, so strips can be added or
+  // lengthened from the web UI without a reboot (the longest strip may grow by as much).
+  uint16_t pixelHeadroom = 0;
 
   uint8_t subdeviceCount = 0;
   SubdeviceConfig subdevices[MAX_SUBDEVICES];
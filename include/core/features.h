@@ -9,6 +9,11 @@
 #define USE_SACN 1
 #endif
 
+// Art-Net ingest shares the sACN frame pipeline and requires USE_SACN.
+#ifndef USE_ARTNET
+#define USE_ARTNET 1
+#endif
+
 #ifndef USE_OTA
 #define USE_OTA 1
 #endif
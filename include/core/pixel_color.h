@@ -0,0 +1,34 @@
+#ifndef CORE_PIXEL_COLOR_H
+#define CORE_PIXEL_COLOR_H
+
+#include <stdint.h>
+
+#include "core/config.h"
+
+// Per-strip color pipeline, built once when the strip is configured: one 256-entry table
+// folds gamma and brightness, and the color order becomes the input channel each wire byte
+// reads. Encoding a pixel is then three lookups written straight into the output buffer.
+struct PixelColorPipeline {
+  uint8_t lut[256];
+  // Wire byte k carries input channel source[k] (0 = R, 1 = G, 2 = B).
+  uint8_t source[3];
+};
+
+void buildPixelColorPipeline(PixelColorPipeline& pipeline, PixelColorOrder order, uint8_t brightness, float gamma);
+
+// rgb: 3 input slots; out: 3 bytes in wire order.
+static inline void encodePixelColor(const PixelColorPipeline& pipeline, uint8_t* out, const uint8_t* rgb) {
+  out[0] = pipeline.lut[rgb[pipeline.source[0]]];
+  out[1] = pipeline.lut[rgb[pipeline.source[1]]];
+  out[2] = pipeline.lut[rgb[pipeline.source[2]]];
+}
+
+// Encodes `count` R, G, B pixels in place.
+static inline void encodePixelFrame(const PixelColorPipeline& pipeline, uint8_t* frame, uint16_t count) {
+  for (uint16_t p = 0; p < count; p++, frame += 3) {
+    const uint8_t rgb[3] = {frame[0], frame[1], frame[2]};
+    encodePixelColor(pipeline, frame, rgb);
+  }
+}
+
+#endif
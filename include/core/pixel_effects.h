@@ -0,0 +1,55 @@
+#ifndef CORE_PIXEL_EFFECTS_H
+#define CORE_PIXEL_EFFECTS_H
+
+#include <stdint.h>
+
+// Parametric strip effects rendered on the node from a few DMX slots, so an animated strip
+// costs PIXEL_EFFECT_SLOTS slots instead of 3 per pixel. Rendering is integer-only and has no
+// Arduino dependencies, so this module also builds and benchmarks on a Linux host.
+enum PixelEffect : uint8_t {
+  PIXEL_EFFECT_SOLID = 0,
+  PIXEL_EFFECT_CHASE = 1,
+  PIXEL_EFFECT_GRADIENT = 2,
+  PIXEL_EFFECT_NOISE = 3,
+  PIXEL_EFFECT_STROBE = 4,
+  PIXEL_EFFECT_FIRE = 5,
+  PIXEL_EFFECT_COUNT
+};
+
+// Slots: effect, speed, color A (R, G, B), color B (R, G, B), size.
+static constexpr uint8_t PIXEL_EFFECT_SLOTS = 9;
+// Fixed render rate (40 fps); a 1024-pixel frame takes about 31 ms on the wire, so longer
+// strips simply drop the frames their output cannot take yet.
+static constexpr uint32_t PIXEL_EFFECT_FRAME_MS = 25;
+
+struct PixelEffectParams {
+  PixelEffect effect;
+  // 1/256 pixel per ms for moving patterns; 0 freezes the effect.
+  uint8_t speed;
+  uint8_t colorA[3];
+  uint8_t colorB[3];
+  // Pattern length (chase block, gradient half-period, noise/flame scale) is size + 1
+  // pixels; for strobe the flash length.
+  uint8_t size;
+};
+
+struct PixelEffectState {
+  uint32_t phase;
+  uint32_t seed;
+};
+
+// The effect slot is split into PIXEL_EFFECT_COUNT equal ranges.
+void decodePixelEffectParams(const uint8_t* slots, PixelEffectParams& params);
+
+// Whether the effect changes over time; a static one only needs rendering when its
+// parameters change.
+static inline bool pixelEffectAnimated(const PixelEffectParams& params) {
+  return params.effect != PIXEL_EFFECT_SOLID && params.speed != 0;
+}
+
+// Advances the effect by elapsedMs and renders `count` pixels into rgb, 3 bytes per pixel
+// in R, G, B order (encode them for the wire afterwards).
+void renderPixelEffect(const PixelEffectParams& params, PixelEffectState& state, uint32_t elapsedMs, uint8_t* rgb,
+                       uint16_t count);
+
+#endif
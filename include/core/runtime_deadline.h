@@ -0,0 +1,28 @@
+#ifndef CORE_RUNTIME_DEADLINE_H
+#define CORE_RUNTIME_DEADLINE_H
+
+#include <stdint.h>
+
+// Earliest deadline across one loop pass: each stage reports when it next has work and
+// the loop sleeps until then, unless a packet or a config change wakes it first. Times are
+// millis() values, compared wrap-safe.
+struct RuntimeDeadline {
+  uint32_t nowMs = 0;
+  uint32_t waitMs = 0;
+};
+
+static inline void deadlineBegin(RuntimeDeadline& deadline, uint32_t nowMs, uint32_t maxWaitMs) {
+  deadline.nowMs = nowMs;
+  deadline.waitMs = maxWaitMs;
+}
+
+static inline void deadlineIn(RuntimeDeadline& deadline, uint32_t delayMs) {
+  if (delayMs < deadline.waitMs) deadline.waitMs = delayMs;
+}
+
+static inline void deadlineAt(RuntimeDeadline& deadline, uint32_t dueMs) {
+  int32_t remainingMs = (int32_t)(dueMs - deadline.nowMs);
+  deadlineIn(deadline, remainingMs > 0 ? (uint32_t)remainingMs : 0);
+}
+
+#endif
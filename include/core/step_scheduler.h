@@ -0,0 +1,28 @@
+#ifndef CORE_STEP_SCHEDULER_H
+#define CORE_STEP_SCHEDULER_H
+
+#include <stdint.h>
+
+#include "platform/step_timer.h"
+
+// Single event queue for all stepper pulses, ordered by due time and driven by the
+// platform step timer. No Arduino dependency, so it builds against the host timer.
+static constexpr uint8_t STEP_SCHEDULER_MAX_EVENTS = 48;
+
+// Runs from the timer callback with the step timer lock held. Return true with nextDueUs
+// set to stay scheduled, false to drop the event.
+typedef bool (*StepEventHandler)(uint8_t id, uint32_t nowUs, uint32_t& nextDueUs);
+// Runs once after each batch of handled events (still under the lock), e.g. to commit
+// the pin changes the handlers gathered. May be null.
+typedef void (*StepEventFlush)();
+
+void stepSchedulerBegin(StepEventHandler handler, StepEventFlush flush);
+// Inserts the event or moves it to dueUs if already queued.
+void stepSchedulerSchedule(uint8_t id, uint32_t dueUs);
+// Inserts the event only if it is not queued yet.
+void stepSchedulerEnsure(uint8_t id, uint32_t dueUs);
+void stepSchedulerCancel(uint8_t id);
+void stepSchedulerCancelAll();
+bool stepSchedulerPending(uint8_t id);
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef CORE_STEPPER_MOTION_H
+#define CORE_STEPPER_MOTION_H
+
+#include <stdint.h>
+
+#include "platform/step_timer.h"
+
+// Step intervals carry 4 fractional bits (1/16 us) so accumulating them per step keeps
+// sub-microsecond timing at high step rates.
+static constexpr uint8_t STEPPER_INTERVAL_FRACTION_BITS = 4;
+static constexpr uint16_t STEPPER_RAMP_TABLE_SIZE = 256;
+
+// Acceleration ramp from standstill to maxDegPerSec. Entry n holds the mean step interval
+// over ramp steps [n << shift, (n + 1) << shift); a stepper that has taken `level` ramp
+// steps needs exactly `level` steps to brake, walking the same table back down.
+struct StepperRamp {
+  uint32_t steps = 0;
+  uint8_t shift = 0;
+  uint16_t length = 0;
+  uint32_t intervalFixed[STEPPER_RAMP_TABLE_SIZE];
+};
+
+// Fastest step rate per driver: coil sequencing from the timer vs. STEP/DIR pulse trains.
+static constexpr uint32_t STEPPER_COIL_MIN_INTERVAL_US = 100;
+static constexpr uint32_t STEPPER_STEP_DIR_MIN_INTERVAL_US = 20;
+
+// Per-stepper constants derived once when the stepper is configured, so DMX commands run
+// on integer lookups only. Angles and speeds come in as milli-degrees; stepsPerRev already
+// includes any microstep multiplier.
+struct StepperMotionProfile {
+  uint32_t stepsPerRev = 0;
+  uint32_t stepsPerDegQ16 = 0;
+  bool limitsEnabled = false;
+  int32_t minTargetSteps = 0;
+  int32_t maxTargetSteps = 0;
+  uint32_t maxSpeedIntervalUs = 1000;
+  // Indexed by the raw speed channel: 1..128 CW slow -> fast, 129..255 CCW fast -> slow.
+  uint32_t velocityIntervalUs[256];
+};
+
+void buildStepperMotionProfile(StepperMotionProfile& profile, uint32_t stepsPerRev, uint32_t minIntervalUs, int32_t maxMilliDegPerSec, bool limitsEnabled, int32_t minMilliDeg, int32_t maxMilliDeg, int32_t homeOffsetSteps);
+uint32_t computeStepperIntervalUs(uint32_t stepsPerDegQ16, uint32_t milliDegPerSec, uint32_t minIntervalUs);
+int32_t stepperMilliDegToSteps(uint32_t stepsPerDegQ16, int32_t milliDeg);
+
+// Trapezoidal when jerkDegPerSec3 is 0, S-curve otherwise. Returns false (no ramp) when
+// acceleration is off or the ramp would be shorter than one step.
+bool buildStepperRamp(StepperRamp& ramp, uint32_t stepsPerRev, uint32_t minIntervalUs, float maxDegPerSec, float accelDegPerSec2, float jerkDegPerSec3);
+
+static inline uint32_t STEP_TIMER_ISR_ATTR stepperRampInterval(const StepperRamp& ramp, uint32_t level) {
+  uint32_t index = level >> ramp.shift;
+  return ramp.intervalFixed[index < ramp.length ? index : ramp.length - 1];
+}
+
+#endif
@@ -4,15 +4,43 @@
 #include <Arduino.h>
 
 #include "core/config.h"
+#include "core/runtime_deadline.h"
 
+static constexpr uint16_t SACN_UNIVERSE_SLOTS = 512;
+static constexpr uint8_t SACN_SLOT_MASK_WORDS = SACN_UNIVERSE_SLOTS / 32;
+
+// Config edits go to `cfg` on the web/loop task and are published as an immutable
+// snapshot; the runtime adopts it at the start of its next tickSubdevices().
+// initSubdevices() re-initializes every subdevice. publishSubdeviceChanges() diffs `cfg`
+// against the running config index by index and re-initializes only the subdevices whose
+// hardware setup changed; the rest keep their runtime state and keep running.
 void initSubdevices();
+void publishSubdeviceChanges();
 void tickSubdevices();
-void applySacnToSubdevices(uint16_t universe, const uint8_t* dmxSlots, uint16_t slotCount);
+// When tickSubdevices() next has work: pending config/requests, DC ramps, held or polled home switches,
+// pixel frames to show or still waiting for the wire.
+// Stepper pulses run from the step timer and never need the loop.
+void subdevicesNextDeadline(RuntimeDeadline& deadline);
+// changedSlots is an optional SACN_SLOT_MASK_WORDS bitmap (bit n = slot n + 1 changed);
+// only subdevices whose slot footprint overlaps a set bit are decoded. nullptr decodes all.
+void applySacnToSubdevices(uint16_t universe, const uint8_t* dmxSlots, uint16_t slotCount, const uint32_t* changedSlots = nullptr);
 void stopSubdevicesOnLoss();
 
 uint16_t subdeviceMinUniverse();
 uint16_t subdeviceMaxUniverse();
-uint8_t subdeviceSlotWidth(const SubdeviceConfig& sd);
+// Distinct universes the enabled subdevices in `cfg` read, counted up to MAX_UNIVERSES + 1;
+// anything over MAX_UNIVERSES would leave subdevices without dispatch entries.
+uint8_t subdeviceUniversesNeeded();
+uint8_t subdeviceUniverseCount();
+uint16_t subdeviceUniverseAt(uint8_t index);
+// Slots the subdevice reads; a mapped pixel strip continues into the following universes.
+uint16_t subdeviceSlotWidth(const SubdeviceConfig& sd);
+// Consecutive universes from map.universe the subdevice reads (1 unless it is a mapped strip);
+// each one counts toward MAX_UNIVERSES.
+uint8_t subdeviceUniverseSpan(const SubdeviceConfig& sd);
+// Whether the enabled strips in `cfg` fit the pixel frame memory reserved at boot; strips
+// that do not would stay dark until the next boot.
+bool subdevicePixelsFit();
 
 bool addSubdevice(SubdeviceType type, const String& name);
 bool deleteSubdevice(uint8_t index);
@@ -24,4 +52,8 @@ String stepperDriverTypeName(StepperDriverType type);
 String dcDriverTypeName(DcDriverType type);
 String pixelDriverTypeName(PixelDriverType type);
 
+// Static RAM of the subdevice tables in this build (config entry, one snapshot, the runtime
+// arena and its pool capacities, per-stepper heap tables) plus the compiled feature flags.
+String subdeviceMemoryReport();
+
 #endif
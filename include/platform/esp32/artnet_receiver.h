@@ -0,0 +1,35 @@
+#ifndef PLATFORM_ESP32_ARTNET_RECEIVER_H
+#define PLATFORM_ESP32_ARTNET_RECEIVER_H
+
+#include <Arduino.h>
+
+#include "platform/esp32/dmx_packet_view.h"
+
+struct UdpEndpoint;
+
+static constexpr uint16_t ARTNET_PORT = 6454;
+static constexpr uint16_t ARTNET_MAX_PACKET_SIZE = 530;
+
+// Art-Net carries no priority; sources merge with E1.31 at the E1.31 default priority.
+static constexpr uint8_t ARTNET_SOURCE_PRIORITY = 100;
+
+enum ArtnetPollResult : uint8_t {
+  ARTNET_POLL_EMPTY = 0,
+  ARTNET_POLL_IGNORED = 1,
+  ARTNET_POLL_DATA = 2,
+};
+
+// Parses an ArtDMX packet. The 15-bit port-address maps to universe
+// (port-address + universeOffset); sourceId receives a 16-byte id derived from the sender.
+bool artnetParseDmxPacket(const uint8_t* data, size_t len, uint16_t universeOffset, uint32_t senderAddr,
+                          uint8_t* sourceId, DmxPacketView& out);
+
+// universes lists the sACN-numbered universes in use; they are advertised in ArtPollReply.
+bool artnetReceiverBegin(uint16_t universeOffset, const uint16_t* universes, uint8_t universeCount);
+void artnetReceiverSetUniverses(uint16_t universeOffset, const uint16_t* universes, uint8_t universeCount);
+void artnetReceiverStop();
+// ArtPoll requests are answered inside the poll and reported as ARTNET_POLL_IGNORED.
+ArtnetPollResult artnetReceiverPoll(DmxPacketView& out);
+UdpEndpoint* artnetReceiverEndpoint();
+
+#endif
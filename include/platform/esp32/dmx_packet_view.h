@@ -0,0 +1,22 @@
+#ifndef PLATFORM_ESP32_DMX_PACKET_VIEW_H
+#define PLATFORM_ESP32_DMX_PACKET_VIEW_H
+
+#include <Arduino.h>
+
+// Protocol-neutral view of one received DMX universe packet (E1.31 or Art-Net).
+// Pointers reference the receiver's packet buffer and stay valid until its next poll;
+// nothing is copied out of the datagram.
+struct DmxPacketView {
+  const uint8_t* cid = nullptr;  // 16-byte source id
+  uint8_t priority = 0;
+  uint16_t syncAddress = 0;
+  uint8_t sequence = 0;
+  bool sequenced = true;         // false when the protocol disabled sequencing (Art-Net 0)
+  uint8_t options = 0;
+  uint16_t universe = 0;
+  uint8_t startCode = 0;
+  const uint8_t* slots = nullptr;
+  uint16_t slotCount = 0;
+};
+
+#endif
@@ -3,11 +3,23 @@
 
 #include <Arduino.h>
 
+#include "core/runtime_deadline.h"
+
 void startSacn();
 void restartSacn();
+// Ingest stage: drains the receivers and merges/buffers universe frames. Without the
+// dual-core split it also applies them; otherwise applySacnFrames() does on the runtime task.
 void handleSacnPackets();
+void applySacnFrames();
 void enforceDmxLoss();
 
+// Deadline-driven loops: the ingest side sleeps in sacnWaitForPackets() until a packet
+// arrives or its next frame release, sync-hold timeout or source expiry; the runtime side
+// adds when enforceDmxLoss() next has to act.
+void sacnIngestDeadline(RuntimeDeadline& deadline);
+void dmxLossDeadline(RuntimeDeadline& deadline);
+void sacnWaitForPackets(uint32_t timeoutMs);
+
 uint32_t sacnPacketCounter();
 uint16_t lastUniverseSeen();
 uint16_t lastDcRawValue();
@@ -0,0 +1,48 @@
+#ifndef PLATFORM_ESP32_E131_RECEIVER_H
+#define PLATFORM_ESP32_E131_RECEIVER_H
+
+#include <Arduino.h>
+
+#include "core/config.h"
+#include "platform/esp32/dmx_packet_view.h"
+
+struct UdpEndpoint;
+
+static constexpr uint16_t E131_PORT = 5568;
+static constexpr uint16_t E131_MAX_PACKET_SIZE = 638;
+// Sync addresses listened to at once (e.g. one per console or synchronized group).
+static constexpr uint8_t E131_MAX_SYNC_UNIVERSES = 4;
+
+static constexpr uint8_t E131_OPT_PREVIEW = 0x80;
+static constexpr uint8_t E131_OPT_TERMINATED = 0x40;
+static constexpr uint8_t E131_OPT_FORCE_SYNC = 0x20;
+
+enum E131PollResult : uint8_t {
+  E131_POLL_EMPTY = 0,
+  E131_POLL_IGNORED = 1,
+  E131_POLL_DATA = 2,
+  E131_POLL_SYNC = 3,
+};
+
+// Universe synchronization packet (E1.31 extended root vector, framing vector 1).
+struct E131SyncView {
+  const uint8_t* cid = nullptr;
+  uint8_t sequence = 0;
+  uint16_t syncAddress = 0;
+};
+
+bool e131ParseDataPacket(const uint8_t* data, size_t len, DmxPacketView& out);
+bool e131ParseSyncPacket(const uint8_t* data, size_t len, E131SyncView& out);
+
+// In multicast mode the receiver joins the group of each listed universe.
+bool e131ReceiverBegin(SacnMode mode, const uint16_t* universes, uint8_t universeCount);
+// Joins/leaves only the groups that differ from the current membership; the socket stays open.
+void e131ReceiverSetUniverses(SacnMode mode, const uint16_t* universes, uint8_t universeCount);
+// Sync addresses whose multicast groups sync packets arrive on; an empty list leaves them all.
+void e131ReceiverSetSyncUniverses(SacnMode mode, const uint16_t* syncAddresses, uint8_t count);
+void e131ReceiverStop();
+E131PollResult e131ReceiverPoll(DmxPacketView& data, E131SyncView& sync);
+// Receiver socket, for waiting on packets across receivers.
+UdpEndpoint* e131ReceiverEndpoint();
+
+#endif
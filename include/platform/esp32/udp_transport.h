@@ -0,0 +1,31 @@
+#ifndef PLATFORM_ESP32_UDP_TRANSPORT_H
+#define PLATFORM_ESP32_UDP_TRANSPORT_H
+
+#include <Arduino.h>
+
+#if defined(ESP8266)
+#include <WiFiUdp.h>
+#endif
+
+// Non-blocking UDP endpoint shared by the DMX-over-IP receivers (lwIP sockets on ESP32,
+// WiFiUDP on ESP8266). Addresses are IPv4 in host byte order.
+struct UdpEndpoint {
+#if defined(ESP32)
+  int socket = -1;
+#elif defined(ESP8266)
+  WiFiUDP udp;
+#endif
+  bool open = false;
+};
+
+bool udpOpen(UdpEndpoint& endpoint, uint16_t port);
+void udpClose(UdpEndpoint& endpoint);
+bool udpJoinGroup(UdpEndpoint& endpoint, uint32_t groupAddr);
+void udpLeaveGroup(UdpEndpoint& endpoint, uint32_t groupAddr);
+int udpReceive(UdpEndpoint& endpoint, uint8_t* buf, size_t cap, uint32_t* fromAddr);
+// Blocks until one of the open endpoints has a datagram or timeoutMs has passed. ESP8266
+// cannot block on WiFiUDP, so it only yields to the SDK for up to 1 ms there.
+bool udpWaitReadable(UdpEndpoint* const* endpoints, uint8_t count, uint32_t timeoutMs);
+bool udpSendTo(UdpEndpoint& endpoint, uint32_t addr, uint16_t port, const uint8_t* data, size_t len);
+
+#endif
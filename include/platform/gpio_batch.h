@@ -0,0 +1,47 @@
+#ifndef PLATFORM_GPIO_BATCH_H
+#define PLATFORM_GPIO_BATCH_H
+
+#include <stdint.h>
+
+// Digital output changes gathered into per-bank set/clear masks and committed with one
+// register write per bank: ESP32 GPIO.out_w1ts/out_w1tc (out1_* for pins >= 32), ESP8266
+// GPOS/GPOC. Host builds record the committed masks (platform/host/gpio_batch.h).
+#if defined(ARDUINO)
+#include <Arduino.h>
+#define GPIO_BATCH_ISR_ATTR IRAM_ATTR
+#else
+#define GPIO_BATCH_ISR_ATTR
+#endif
+
+static constexpr uint8_t GPIO_BATCH_BANKS = 2;
+
+struct GpioBatch {
+  uint32_t setMask[GPIO_BATCH_BANKS] = {0, 0};
+  uint32_t clearMask[GPIO_BATCH_BANKS] = {0, 0};
+};
+
+// The last write to a pin before the commit wins. Unassigned pins (255) are ignored.
+static inline void GPIO_BATCH_ISR_ATTR gpioBatchWrite(GpioBatch& batch, uint8_t pin, bool high) {
+  if (pin >= 32 * GPIO_BATCH_BANKS) return;
+  const uint8_t bank = pin >> 5;
+  const uint32_t bit = 1u << (pin & 31);
+  if (high) {
+    batch.setMask[bank] |= bit;
+    batch.clearMask[bank] &= ~bit;
+  } else {
+    batch.clearMask[bank] |= bit;
+    batch.setMask[bank] &= ~bit;
+  }
+}
+
+static inline bool GPIO_BATCH_ISR_ATTR gpioBatchPending(const GpioBatch& batch) {
+  for (uint8_t bank = 0; bank < GPIO_BATCH_BANKS; bank++) {
+    if (batch.setMask[bank] || batch.clearMask[bank]) return true;
+  }
+  return false;
+}
+
+// Applies and empties the batch. Banks with nothing pending are not touched.
+void gpioBatchCommit(GpioBatch& batch);
+
+#endif
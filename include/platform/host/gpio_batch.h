@@ -0,0 +1,20 @@
+#ifndef PLATFORM_HOST_GPIO_BATCH_H
+#define PLATFORM_HOST_GPIO_BATCH_H
+
+#include <stdint.h>
+
+#include "platform/gpio_batch.h"
+
+// Host (Linux) backend: commits only update a simulated output latch and are recorded, so
+// callers can check how many register writes a tick cost and which pins switched together.
+struct HostGpioCommit {
+  uint32_t setMask[GPIO_BATCH_BANKS];
+  uint32_t clearMask[GPIO_BATCH_BANKS];
+};
+
+void hostGpioBatchReset();
+uint32_t hostGpioBatchCommitCount();
+const HostGpioCommit& hostGpioBatchLastCommit();
+bool hostGpioLevel(uint8_t pin);
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef PLATFORM_HOST_STEP_TIMER_H
+#define PLATFORM_HOST_STEP_TIMER_H
+
+#include <stdint.h>
+
+#include "platform/step_timer.h"
+
+// Host (Linux) backend: time only moves when the caller advances it, and every armed
+// deadline inside the advanced window fires in order, so scheduling is deterministic.
+void hostStepTimerReset(uint32_t nowUs);
+void hostStepTimerAdvance(uint32_t deltaUs);
+bool hostStepTimerArmed();
+uint32_t hostStepTimerDeadlineUs();
+
+#endif
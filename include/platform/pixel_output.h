@@ -0,0 +1,55 @@
+#ifndef PLATFORM_PIXEL_OUTPUT_H
+#define PLATFORM_PIXEL_OUTPUT_H
+
+#include <stdint.h>
+
+// Double-buffered WS2812 (800 kHz) strip output. The caller encodes a frame into the back
+// buffer (3 bytes per pixel, already in the strip's wire order) and marks it with
+// pixelOutputShow(); pixelOutputFlush() then starts every marked frame whose output is idle
+// and returns at once. On the classic ESP32 the first eight strips are lanes of one I2S
+// parallel group: a flush encodes all their frames into a single DMA transfer that clocks
+// them out together, so the group costs one frame time however many strips it drives. RMT
+// channels take strips beyond that. The back buffer keeps the shown frame, so a caller may
+// rewrite only the pixels that changed, and only the newest marked frame goes out. Boards
+// without that hardware fall back to a blocking send per strip.
+static constexpr uint8_t PIXEL_OUTPUT_NONE = 0xFF;
+static constexpr uint8_t PIXEL_OUTPUT_BYTES_PER_PIXEL = 3;
+
+// Frame memory, for the boot log and status page. The arena and DMA frame are reserved once;
+// used/peak count the frame buffers carved from them (the strips' own buffers on boards
+// without DMA output), and headroomPixels estimates how many more pixels the largest free
+// heap block could take at the next boot.
+struct PixelOutputMemory {
+  uint32_t arenaBytes = 0;
+  uint32_t arenaLargestFree = 0;
+  uint32_t framesUsed = 0;
+  uint32_t framesPeak = 0;
+  uint32_t dmaBytes = 0;
+  uint16_t dmaPixels = 0;
+  uint16_t dmaPeakPixels = 0;
+  uint16_t refused = 0;
+  uint32_t heapFree = 0;
+  uint32_t heapLargest = 0;
+  uint32_t headroomPixels = 0;
+};
+
+// Reserves the frame arena for `pixels` pixels in total and the parallel DMA frame for
+// strips of up to `lanePixels`, once at boot; later calls do nothing. Strips that do not fit
+// what was reserved are refused until the next boot.
+void pixelOutputReserve(uint32_t pixels, uint16_t lanePixels);
+// Whether strips of `pixels` in total, the longest `lanePixels`, fit what was reserved;
+// boards whose strips allocate their own buffers always fit.
+bool pixelOutputFits(uint32_t pixels, uint16_t lanePixels);
+
+// Returns PIXEL_OUTPUT_NONE when no output (or reserved frame memory) is left.
+uint8_t pixelOutputAttach(uint8_t pin, uint16_t count);
+// Lets a frame on the wire finish, then frees the output and its buffers.
+void pixelOutputDetach(uint8_t output);
+// Valid until the next attach, which may move frame buffers to compact the arena.
+uint8_t* pixelOutputBuffer(uint8_t output);
+void pixelOutputShow(uint8_t output);
+// Starts the marked frames of idle outputs; true while a marked frame still waits.
+bool pixelOutputFlush();
+void pixelOutputMemory(PixelOutputMemory& memory);
+
+#endif
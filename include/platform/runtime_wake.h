@@ -0,0 +1,17 @@
+#ifndef PLATFORM_RUNTIME_WAKE_H
+#define PLATFORM_RUNTIME_WAKE_H
+
+#include <stdint.h>
+
+// Lets the runtime task sleep until its next deadline and be woken early: by packet ingest
+// after it hands over frames, by the web task after it publishes config or a test/home
+// request. Only a task that called runtimeWakeBind() is woken; in the single-core loop
+// notifications are dropped, since the loop does that work itself.
+void runtimeWakeBind();
+void runtimeWakeNotify();
+// Same, from an interrupt handler (home/e-stop switch edges).
+void runtimeWakeNotifyFromIsr();
+// Sleeps up to timeoutMs (rounded up to scheduler ticks); returns early when notified.
+void runtimeWakeWait(uint32_t timeoutMs);
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef PLATFORM_STEP_PULSE_H
+#define PLATFORM_STEP_PULSE_H
+
+#include <stdint.h>
+
+#include "platform/step_timer.h"
+
+// Hardware STEP pulse trains for STEP/DIR drivers. On ESP32 each axis gets an RMT channel:
+// the caller hands over a batch of step gaps, they are written straight into the channel's
+// RMT memory and the peripheral emits one STEP pulse per entry, gapsUs[k] apart. The batch
+// ends right after its last pulse (the last gap is left to the caller's timer). No driver
+// calls or locks, so batches can be sent from the step timer callback. Where no channel is
+// available the caller pulses STEP from the step timer instead.
+static constexpr uint8_t STEP_PULSE_NO_CHANNEL = 0xFF;
+static constexpr uint32_t STEP_PULSE_WIDTH_US = 2;
+// One RMT memory block: 63 pulse items plus the end marker, each gap at most 15 bits.
+static constexpr uint8_t STEP_PULSE_MAX_BATCH = 63;
+static constexpr uint32_t STEP_PULSE_MAX_GAP_US = 32767;
+
+uint8_t stepPulseAttach(uint8_t stepPin);
+void stepPulseDetach(uint8_t channel);
+// Starts a batch on an idle channel (intervals are copied); false if the channel is busy.
+bool stepPulseSend(uint8_t channel, const uint32_t* gapsUs, uint8_t count);
+bool stepPulseIdle(uint8_t channel);
+// Blocks until the running batch has finished or timeoutUs has elapsed.
+void stepPulseWaitIdle(uint8_t channel, uint32_t timeoutUs);
+void stepPulseAbort(uint8_t channel);
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef PLATFORM_STEP_TIMER_H
+#define PLATFORM_STEP_TIMER_H
+
+#include <stdint.h>
+
+// One-shot microsecond timer that drives the stepper pulse scheduler. ESP32 uses esp_timer,
+// ESP8266 uses timer1, host builds use a simulated clock (platform/host/step_timer.h).
+#if defined(ARDUINO)
+#include <Arduino.h>
+#define STEP_TIMER_ISR_ATTR IRAM_ATTR
+#else
+#define STEP_TIMER_ISR_ATTR
+#endif
+
+typedef void (*StepTimerCallback)();
+
+bool stepTimerBegin(StepTimerCallback callback);
+// Fires the callback once after delayUs, replacing any pending arm.
+void stepTimerArm(uint32_t delayUs);
+void stepTimerDisarm();
+uint32_t stepTimerNowUs();
+
+// Nestable critical section shared by the timer callback and runtime code touching
+// state the callback reads.
+void stepTimerLock();
+void stepTimerUnlock();
+
+#endif
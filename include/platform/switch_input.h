@@ -0,0 +1,21 @@
+#ifndef PLATFORM_SWITCH_INPUT_H
+#define PLATFORM_SWITCH_INPUT_H
+
+#include <stdint.h>
+
+#include "platform/step_timer.h"
+
+// Edge interrupts for home/e-stop switches. The handler runs in interrupt context on every
+// edge of the pin (both directions), with the pin's level already decoded against its
+// polarity; debouncing is left to the caller, which knows what an edge means. Handlers must
+// be STEP_TIMER_ISR_ATTR and keep to the step timer lock, pulse aborts and wake-ups.
+typedef void (*SwitchInputHandler)(void* arg, bool active);
+
+// Configures the pin as an input (pull-up when active low) and hooks its edge interrupt.
+// Returns false where the pin cannot interrupt (ESP8266 GPIO16); the caller then polls it.
+bool switchInputAttach(uint8_t pin, bool activeLow, SwitchInputHandler handler, void* arg);
+void switchInputDetach(uint8_t pin);
+// Register read, safe from interrupts.
+bool switchInputActive(uint8_t pin, bool activeLow);
+
+#endif
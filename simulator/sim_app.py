@@ -29,7 +29,7 @@ SUBDEVICE_TYPES = {
     4: "Pixel Strip",
 }
 
-MAX_SUBDEVICES = 12
+MAX_SUBDEVICES = 64
 
 
 @dataclass
@@ -88,9 +88,12 @@ class LedRuntimeConfig:
 
 @dataclass
 class PixelRuntimeConfig:
+    mode: int = 0  # 0 solid (3 slots), 1 mapped (3 slots per pixel, spanning universes), 2 effect (9 slots)
     pin: int = 26
     count: int = 30
     brightness: int = 50
+    colorOrder: int = 0  # 0 GRB, 1 RGB, 2 BRG, 3 RBG, 4 GBR, 5 BGR
+    gamma: float = 1.0
 
 
 @dataclass
@@ -281,7 +284,16 @@ class SimApp:
         self.dmx_active = True
 
         for sd in self.cfg.subdevices:
-            if not sd.enabled or sd.map.universe != universe:
+            if not sd.enabled:
+                continue
+            if sd.type == 4 and sd.pixels.mode == 1:  # mapped pixels
+                for seg_universe, addr, first, count in pixel_segments(sd):
+                    if seg_universe != universe:
+                        continue
+                    rgb = [[slots.get(addr + 3 * k + c, 0) for c in range(3)] for k in range(count)]
+                    self.probe.emit("pixels_mapped", {"name": sd.name, "universe": universe, "first": first, "rgb": rgb})
+                continue
+            if sd.map.universe != universe:
                 continue
             addr = sd.map.startAddr
             if sd.type == 1:  # DC
@@ -326,11 +338,39 @@ class SimApp:
             elif sd.type == 3:  # led
                 on = slots.get(addr, 0) >= 128
                 self.probe.emit("led", {"name": sd.name, "on": on})
+            elif sd.type == 4 and sd.pixels.mode == 2:  # effect pixels
+                v = [slots.get(addr + k, 0) for k in range(9)]
+                self.probe.emit("pixels_effect", {
+                    "name": sd.name,
+                    "effect": PIXEL_EFFECTS[v[0] * len(PIXEL_EFFECTS) >> 8],
+                    "speed": v[1],
+                    "colorA": v[2:5],
+                    "colorB": v[5:8],
+                    "size": v[8],
+                    "count": sd.pixels.count,
+                })
             elif sd.type == 4:  # pixels
                 rgb = [slots.get(addr, 0), slots.get(addr + 1, 0), slots.get(addr + 2, 0)]
                 self.probe.emit("pixels", {"name": sd.name, "rgb": rgb, "count": sd.pixels.count})
 
 
+# Effect slot ranges, as in core/pixel_effects.h.
+PIXEL_EFFECTS = ["solid", "chase", "gradient", "noise", "strobe", "fire"]
+
+
+def pixel_segments(sd: SubdeviceConfig) -> list[tuple[int, int, int, int]]:
+    # (universe, start address, first pixel, pixel count); 170 pixels per following universe.
+    segments = []
+    universe, offset, pixel = sd.map.universe, sd.map.startAddr - 1, 0
+    while pixel < sd.pixels.count and len(segments) < 8:
+        take = min((512 - offset) // 3, sd.pixels.count - pixel)
+        if take > 0:
+            segments.append((universe, offset + 1, pixel, take))
+            pixel += take
+        universe, offset = universe + 1, 0
+    return segments
+
+
 def esc(s: str) -> str:
     return (
         s.replace("&", "&amp;")
@@ -490,9 +530,21 @@ def render_type_specific_fields(sd: SubdeviceConfig) -> str:
     if sd.type == 4:
         return (
             "<fieldset><legend>Pixel Strip</legend>"
+            "Mode <select name='pxmode'>"
+            f"<option value='0'{' selected' if sd.pixels.mode == 0 else ''}>Solid (3 slots)</option>"
+            f"<option value='1'{' selected' if sd.pixels.mode == 1 else ''}>Mapped (3 slots per pixel)</option>"
+            f"<option value='2'{' selected' if sd.pixels.mode == 2 else ''}>Effect (9 slots)</option>"
+            "</select><br><br>"
             f"Pixel pin <input name='pxpin' type='number' value='{sd.pixels.pin}'> "
             f"Count <input name='pxcount' type='number' value='{sd.pixels.count}'> "
-            f"Brightness <input name='pxb' type='number' value='{sd.pixels.brightness}'></fieldset><br>"
+            f"Brightness <input name='pxb' type='number' value='{sd.pixels.brightness}'><br>"
+            "Color order <select name='pxorder'>"
+            + "".join(
+                f"<option value='{v}'{' selected' if sd.pixels.colorOrder == v else ''}>{n}</option>"
+                for v, n in enumerate(["GRB (WS2812B)", "RGB", "BRG", "RBG", "GBR", "BGR"])
+            )
+            + "</select> "
+            f"Gamma <input name='pxgamma' type='number' step='0.1' value='{sd.pixels.gamma}'></fieldset><br>"
         )
     return ""
 
@@ -671,9 +723,12 @@ class Handler(BaseHTTPRequestHandler):
                 sd.led.pin = int(data.get("ledpin", [str(sd.led.pin)])[0])
                 sd.led.activeHigh = "ledah" in data
             elif sd.type == 4:
+                sd.pixels.mode = int(data.get("pxmode", [str(sd.pixels.mode)])[0])
                 sd.pixels.pin = int(data.get("pxpin", [str(sd.pixels.pin)])[0])
                 sd.pixels.count = int(data.get("pxcount", [str(sd.pixels.count)])[0])
                 sd.pixels.brightness = int(data.get("pxb", [str(sd.pixels.brightness)])[0])
+                sd.pixels.colorOrder = int(data.get("pxorder", [str(sd.pixels.colorOrder)])[0])
+                sd.pixels.gamma = float(data.get("pxgamma", [str(sd.pixels.gamma)])[0])
 
             self.app.save()
             return self._redirect("/subdevices")
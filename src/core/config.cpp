@@ -1,3 +1,14 @@
 #include "core/config.h"
 
 AppConfig cfg;
+
+void setSubdeviceType(SubdeviceConfig& sd, SubdeviceType type) {
+  sd.type = type;
+  switch (type) {
+    case SUBDEVICE_DC_MOTOR: sd.dc = DcMotorRuntimeConfig(); break;
+    case SUBDEVICE_RELAY: sd.relay = RelayRuntimeConfig(); break;
+    case SUBDEVICE_LED: sd.led = LedRuntimeConfig(); break;
+    case SUBDEVICE_PIXELS: sd.pixels = PixelRuntimeConfig(); break;
+    default: sd.stepper = StepperRuntimeConfig(); break;
+  }
+}
@@ -0,0 +1,25 @@
+#include "core/pixel_color.h"
+
+#include <math.h>
+
+// Input channel of each wire byte, per PixelColorOrder.
+static constexpr uint8_t PIXEL_ORDER_SOURCES[][3] = {
+  {1, 0, 2},  // GRB
+  {0, 1, 2},  // RGB
+  {2, 0, 1},  // BRG
+  {0, 2, 1},  // RBG
+  {1, 2, 0},  // GBR
+  {2, 1, 0},  // BGR
+};
+
+void buildPixelColorPipeline(PixelColorPipeline& pipeline, PixelColorOrder order, uint8_t brightness, float gamma) {
+  if (order > PIXEL_ORDER_BGR) order = PIXEL_ORDER_GRB;
+  for (uint8_t k = 0; k < 3; k++) pipeline.source[k] = PIXEL_ORDER_SOURCES[order][k];
+
+  // Gamma first, then brightness (255 passes full scale), so dimmed strips keep the curve.
+  const uint16_t scale = (uint16_t)(brightness + 1);
+  for (uint16_t v = 0; v < 256; v++) {
+    uint16_t level = gamma == 1.0f ? v : (uint16_t)(255.0f * powf((float)v / 255.0f, gamma) + 0.5f);
+    pipeline.lut[v] = (uint8_t)((level * scale) >> 8);
+  }
+}
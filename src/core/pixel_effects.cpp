@@ -0,0 +1,151 @@
+#include "core/pixel_effects.h"
+
+// Phase runs in 1/256 pixel; noise time and strobe periods are derived from it.
+static constexpr uint8_t NOISE_TIME_SHIFT = 6;
+static constexpr uint8_t FIRE_TIME_SHIFT = 4;
+static constexpr uint8_t FIRE_SCROLL_SHIFT = 2;
+// Speed 255 flashes at about 15 Hz, speed 16 about once a second.
+static constexpr uint32_t STROBE_PERIOD = 16384;
+static constexpr uint32_t STROBE_FLASH_PER_SIZE = 32;
+
+void decodePixelEffectParams(const uint8_t* slots, PixelEffectParams& params) {
+  params.effect = (PixelEffect)((slots[0] * PIXEL_EFFECT_COUNT) >> 8);
+  params.speed = slots[1];
+  for (uint8_t c = 0; c < 3; c++) {
+    params.colorA[c] = slots[2 + c];
+    params.colorB[c] = slots[5 + c];
+  }
+  params.size = slots[8];
+}
+
+// w runs 0 (all a) .. 256 (all b).
+static inline void mixColor(uint8_t* out, const uint8_t* a, const uint8_t* b, uint16_t w) {
+  const uint16_t v = (uint16_t)(256 - w);
+  out[0] = (uint8_t)((a[0] * v + b[0] * w) >> 8);
+  out[1] = (uint8_t)((a[1] * v + b[1] * w) >> 8);
+  out[2] = (uint8_t)((a[2] * v + b[2] * w) >> 8);
+}
+
+static inline uint8_t mix8(uint8_t a, uint8_t b, uint16_t w) {
+  return (uint8_t)((a * (256 - w) + b * w) >> 8);
+}
+
+static void fillColor(uint8_t* rgb, uint16_t count, const uint8_t* color) {
+  for (uint16_t p = 0; p < count; p++, rgb += 3) {
+    rgb[0] = color[0];
+    rgb[1] = color[1];
+    rgb[2] = color[2];
+  }
+}
+
+// Blocks of color A and B, size + 1 pixels each (chase), or a triangle blend between them
+// over the same period (gradient), both moving toward the end of the strip.
+static void renderBands(const PixelEffectParams& params, uint32_t phase, uint8_t* rgb, uint16_t count, bool blend) {
+  const uint32_t length = (uint32_t)params.size + 1;
+  const uint32_t half = length << 8;
+  const uint32_t period = half * 2;
+  uint32_t u = period - phase % period;
+  for (uint16_t p = 0; p < count; p++, rgb += 3) {
+    if (u >= period) u -= period;
+    if (!blend) {
+      mixColor(rgb, params.colorA, params.colorB, u < half ? 0 : 256);
+    } else {
+      mixColor(rgb, params.colorA, params.colorB, (uint16_t)((u < half ? u : period - u) / length));
+    }
+    u += 256;
+  }
+}
+
+// Integer hash of a lattice point, 0..255.
+static inline uint8_t latticeValue(uint32_t x, uint32_t t, uint32_t seed) {
+  uint32_t h = x * 0x9E3779B1u ^ t * 0x85EBCA77u ^ seed;
+  h ^= h >> 15;
+  h *= 0x2C1B3C6Du;
+  h ^= h >> 12;
+  return (uint8_t)(h >> 24);
+}
+
+// Smoothstep on 0..255, returned as a 0..256 weight.
+static inline uint16_t smoothWeight(uint8_t f) {
+  const uint32_t x = f;
+  return (uint16_t)((x * x * (768 - 2 * x)) >> 16);
+}
+
+// 2D value noise over (pixel / (size + 1), time): each lattice cell is blended once in
+// time when the walk enters it, then each pixel only blends across the cell.
+static void renderNoise(const PixelEffectParams& params, uint32_t seed, uint32_t x0, uint32_t t, uint8_t* heat,
+                        uint16_t count) {
+  const uint32_t step = 65536u / ((uint32_t)params.size + 1);
+  const uint32_t tCell = t >> 8;
+  const uint16_t tw = smoothWeight((uint8_t)t);
+  uint32_t x = x0;
+  uint32_t cell = ~(x >> 16);
+  uint8_t v0 = 0;
+  uint8_t v1 = 0;
+  for (uint16_t p = 0; p < count; p++, x += step) {
+    if (x >> 16 != cell) {
+      cell = x >> 16;
+      v0 = mix8(latticeValue(cell, tCell, seed), latticeValue(cell, tCell + 1, seed), tw);
+      v1 = mix8(latticeValue(cell + 1, tCell, seed), latticeValue(cell + 1, tCell + 1, seed), tw);
+    }
+    heat[p] = mix8(v0, v1, smoothWeight((uint8_t)(x >> 8)));
+  }
+}
+
+// Noise levels are walked into the first `count` bytes of the frame, then expanded to
+// colors from the last pixel back, which never overwrites a level still to be read.
+// Fire scrolls the noise toward the end of the strip, fades it out along the strip and
+// maps it through black -> color B -> color A.
+static void renderNoiseEffect(const PixelEffectParams& params, const PixelEffectState& state, uint8_t* rgb,
+                              uint16_t count, bool fire) {
+  static const uint8_t black[3] = {0, 0, 0};
+  if (!fire) {
+    renderNoise(params, state.seed, 0, state.phase >> NOISE_TIME_SHIFT, rgb, count);
+    for (uint16_t p = count; p-- > 0;) mixColor(rgb + 3 * p, params.colorA, params.colorB, rgb[p]);
+    return;
+  }
+  const uint32_t step = 65536u / ((uint32_t)params.size + 1);
+  const uint32_t scroll = (uint32_t)(((uint64_t)(state.phase >> FIRE_SCROLL_SHIFT) * step) >> 8);
+  renderNoise(params, state.seed, 0u - scroll, state.phase >> FIRE_TIME_SHIFT, rgb, count);
+  const uint32_t taperStep = (256u << 16) / count;
+  for (uint16_t p = count; p-- > 0;) {
+    const uint16_t heat = (uint16_t)((rgb[p] * (256 - ((p * taperStep) >> 16))) >> 8);
+    if (heat < 128) {
+      mixColor(rgb + 3 * p, black, params.colorB, (uint16_t)(heat * 2));
+    } else {
+      mixColor(rgb + 3 * p, params.colorB, params.colorA, (uint16_t)((heat - 128) * 2));
+    }
+  }
+}
+
+void renderPixelEffect(const PixelEffectParams& params, PixelEffectState& state, uint32_t elapsedMs, uint8_t* rgb,
+                       uint16_t count) {
+  if (count == 0) return;
+  const uint32_t previous = state.phase;
+  state.phase += params.speed * elapsedMs;
+  const uint32_t phase = state.phase;
+  switch (params.effect) {
+    case PIXEL_EFFECT_CHASE:
+      renderBands(params, phase, rgb, count, false);
+      break;
+    case PIXEL_EFFECT_GRADIENT:
+      renderBands(params, phase, rgb, count, true);
+      break;
+    case PIXEL_EFFECT_NOISE:
+      renderNoiseEffect(params, state, rgb, count, false);
+      break;
+    case PIXEL_EFFECT_STROBE: {
+      // A flash that started since the last frame shows for at least one frame.
+      const bool flash = previous / STROBE_PERIOD != phase / STROBE_PERIOD ||
+                         phase % STROBE_PERIOD < ((uint32_t)params.size + 1) * STROBE_FLASH_PER_SIZE;
+      fillColor(rgb, count, flash ? params.colorA : params.colorB);
+      break;
+    }
+    case PIXEL_EFFECT_FIRE:
+      renderNoiseEffect(params, state, rgb, count, true);
+      break;
+    default:
+      fillColor(rgb, count, params.colorA);
+      break;
+  }
+}
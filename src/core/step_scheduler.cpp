@@ -0,0 +1,161 @@
+#include "core/step_scheduler.h"
+
+// Upper bound on events handled per timer callback, so a backlog (e.g. after flash
+// writes held the timer off) is paced out instead of monopolizing the CPU.
+static constexpr uint8_t STEP_SCHEDULER_EVENTS_PER_CALLBACK = 32;
+static constexpr uint32_t STEP_SCHEDULER_BACKLOG_DELAY_US = 20;
+static constexpr uint8_t STEP_SCHEDULER_NOT_QUEUED = 0xFF;
+
+struct StepEvent {
+  uint32_t dueUs = 0;
+  uint8_t id = 0;
+};
+
+// Binary min-heap on dueUs (wrap-safe compare) with a per-id heap position index.
+static StepEvent eventHeap[STEP_SCHEDULER_MAX_EVENTS];
+static uint8_t eventHeapSize = 0;
+static uint8_t eventPosition[STEP_SCHEDULER_MAX_EVENTS];
+static StepEventHandler eventHandler = nullptr;
+static StepEventFlush eventFlush = nullptr;
+static bool schedulerStarted = false;
+
+static inline bool STEP_TIMER_ISR_ATTR dueBefore(uint32_t a, uint32_t b) {
+  return (int32_t)(a - b) < 0;
+}
+
+static void STEP_TIMER_ISR_ATTR placeEvent(uint8_t pos, const StepEvent& event) {
+  eventHeap[pos] = event;
+  eventPosition[event.id] = pos;
+}
+
+static void STEP_TIMER_ISR_ATTR siftUp(uint8_t pos) {
+  StepEvent event = eventHeap[pos];
+  while (pos > 0) {
+    uint8_t parent = (uint8_t)((pos - 1) >> 1);
+    if (!dueBefore(event.dueUs, eventHeap[parent].dueUs)) break;
+    placeEvent(pos, eventHeap[parent]);
+    pos = parent;
+  }
+  placeEvent(pos, event);
+}
+
+static void STEP_TIMER_ISR_ATTR siftDown(uint8_t pos) {
+  StepEvent event = eventHeap[pos];
+  while (true) {
+    uint8_t child = (uint8_t)(pos * 2 + 1);
+    if (child >= eventHeapSize) break;
+    if (child + 1 < eventHeapSize && dueBefore(eventHeap[child + 1].dueUs, eventHeap[child].dueUs)) child++;
+    if (!dueBefore(eventHeap[child].dueUs, event.dueUs)) break;
+    placeEvent(pos, eventHeap[child]);
+    pos = child;
+  }
+  placeEvent(pos, event);
+}
+
+static void STEP_TIMER_ISR_ATTR removeAt(uint8_t pos) {
+  eventPosition[eventHeap[pos].id] = STEP_SCHEDULER_NOT_QUEUED;
+  eventHeapSize--;
+  if (pos == eventHeapSize) return;
+  uint8_t movedId = eventHeap[eventHeapSize].id;
+  placeEvent(pos, eventHeap[eventHeapSize]);
+  siftDown(pos);
+  siftUp(eventPosition[movedId]);
+}
+
+static void STEP_TIMER_ISR_ATTR armForHead(uint32_t nowUs) {
+  if (eventHeapSize == 0) {
+    stepTimerDisarm();
+    return;
+  }
+  uint32_t dueUs = eventHeap[0].dueUs;
+  stepTimerArm(dueBefore(nowUs, dueUs) ? dueUs - nowUs : 0);
+}
+
+static void STEP_TIMER_ISR_ATTR onStepTimer() {
+  stepTimerLock();
+  uint32_t nowUs = stepTimerNowUs();
+  uint8_t budget = STEP_SCHEDULER_EVENTS_PER_CALLBACK;
+  while (eventHeapSize > 0 && !dueBefore(nowUs, eventHeap[0].dueUs)) {
+    if (budget-- == 0) {
+      if (eventFlush) eventFlush();
+      stepTimerArm(STEP_SCHEDULER_BACKLOG_DELAY_US);
+      stepTimerUnlock();
+      return;
+    }
+    uint32_t nextDueUs = nowUs;
+    if (eventHandler && eventHandler(eventHeap[0].id, nowUs, nextDueUs)) {
+      eventHeap[0].dueUs = nextDueUs;
+      siftDown(0);
+    } else {
+      removeAt(0);
+    }
+    nowUs = stepTimerNowUs();
+  }
+  if (eventFlush) eventFlush();
+  armForHead(nowUs);
+  stepTimerUnlock();
+}
+
+void stepSchedulerBegin(StepEventHandler handler, StepEventFlush flush) {
+  stepTimerLock();
+  eventHandler = handler;
+  eventFlush = flush;
+  if (!schedulerStarted) {
+    eventHeapSize = 0;
+    for (uint8_t i = 0; i < STEP_SCHEDULER_MAX_EVENTS; i++) eventPosition[i] = STEP_SCHEDULER_NOT_QUEUED;
+  }
+  stepTimerUnlock();
+  if (!schedulerStarted) schedulerStarted = stepTimerBegin(onStepTimer);
+}
+
+void stepSchedulerSchedule(uint8_t id, uint32_t dueUs) {
+  if (id >= STEP_SCHEDULER_MAX_EVENTS || !schedulerStarted) return;
+  stepTimerLock();
+  uint8_t pos = eventPosition[id];
+  if (pos == STEP_SCHEDULER_NOT_QUEUED) {
+    pos = eventHeapSize++;
+    StepEvent event;
+    event.id = id;
+    event.dueUs = dueUs;
+    placeEvent(pos, event);
+    siftUp(pos);
+  } else {
+    eventHeap[pos].dueUs = dueUs;
+    siftUp(pos);
+    siftDown(eventPosition[id]);
+  }
+  if (eventPosition[id] == 0) armForHead(stepTimerNowUs());
+  stepTimerUnlock();
+}
+
+void stepSchedulerEnsure(uint8_t id, uint32_t dueUs) {
+  if (id >= STEP_SCHEDULER_MAX_EVENTS || !schedulerStarted) return;
+  stepTimerLock();
+  if (eventPosition[id] == STEP_SCHEDULER_NOT_QUEUED) stepSchedulerSchedule(id, dueUs);
+  stepTimerUnlock();
+}
+
+void stepSchedulerCancel(uint8_t id) {
+  if (id >= STEP_SCHEDULER_MAX_EVENTS || !schedulerStarted) return;
+  stepTimerLock();
+  uint8_t pos = eventPosition[id];
+  if (pos != STEP_SCHEDULER_NOT_QUEUED) {
+    removeAt(pos);
+    if (pos == 0) armForHead(stepTimerNowUs());
+  }
+  stepTimerUnlock();
+}
+
+void stepSchedulerCancelAll() {
+  if (!schedulerStarted) return;
+  stepTimerLock();
+  for (uint8_t i = 0; i < eventHeapSize; i++) eventPosition[eventHeap[i].id] = STEP_SCHEDULER_NOT_QUEUED;
+  eventHeapSize = 0;
+  stepTimerDisarm();
+  stepTimerUnlock();
+}
+
+bool stepSchedulerPending(uint8_t id) {
+  if (id >= STEP_SCHEDULER_MAX_EVENTS || !schedulerStarted) return false;
+  return eventPosition[id] != STEP_SCHEDULER_NOT_QUEUED;
+}
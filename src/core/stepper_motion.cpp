@@ -0,0 +1,147 @@
+#include "core/stepper_motion.h"
+
+#include <math.h>
+
+// Time steps per ramp integration pass; the ramp is built twice (size, then fill) when a
+// stepper is configured, never per command.
+static constexpr uint32_t STEPPER_RAMP_SIM_ITERATIONS = 16384;
+// Slowest velocity-mode speed (speed channel 1 / 255).
+static constexpr int32_t STEPPER_MIN_VELOCITY_MILLIDEG = 1000;
+
+uint32_t computeStepperIntervalUs(uint32_t stepsPerDegQ16, uint32_t milliDegPerSec, uint32_t minIntervalUs) {
+  uint64_t stepsPerSecQ16 = ((uint64_t)milliDegPerSec * stepsPerDegQ16) / 1000;
+  if (stepsPerSecQ16 < (1u << 16)) stepsPerSecQ16 = 1u << 16;
+  uint64_t intervalUs = (1000000ull << 16) / stepsPerSecQ16;
+  if (intervalUs < minIntervalUs) intervalUs = minIntervalUs;
+  return (uint32_t)intervalUs;
+}
+
+int32_t stepperMilliDegToSteps(uint32_t stepsPerDegQ16, int32_t milliDeg) {
+  const int64_t scale = 1000ll << 16;
+  int64_t scaled = (int64_t)milliDeg * stepsPerDegQ16;
+  return (int32_t)(scaled >= 0 ? (scaled + scale / 2) / scale : -((-scaled + scale / 2) / scale));
+}
+
+void buildStepperMotionProfile(StepperMotionProfile& profile, uint32_t stepsPerRev, uint32_t minIntervalUs, int32_t maxMilliDegPerSec, bool limitsEnabled, int32_t minMilliDeg, int32_t maxMilliDeg, int32_t homeOffsetSteps) {
+  profile.stepsPerRev = stepsPerRev;
+  profile.stepsPerDegQ16 = (uint32_t)(((uint64_t)stepsPerRev << 16) / 360);
+  profile.limitsEnabled = limitsEnabled;
+  profile.minTargetSteps = stepperMilliDegToSteps(profile.stepsPerDegQ16, minMilliDeg) + homeOffsetSteps;
+  profile.maxTargetSteps = stepperMilliDegToSteps(profile.stepsPerDegQ16, maxMilliDeg) + homeOffsetSteps;
+  if (maxMilliDegPerSec < STEPPER_MIN_VELOCITY_MILLIDEG) maxMilliDegPerSec = STEPPER_MIN_VELOCITY_MILLIDEG;
+  profile.maxSpeedIntervalUs = computeStepperIntervalUs(profile.stepsPerDegQ16, (uint32_t)maxMilliDegPerSec, minIntervalUs);
+
+  // Linear speed map from the slowest to the configured max speed; raw 0 (absolute mode)
+  // just mirrors the max speed.
+  const int32_t span = maxMilliDegPerSec - STEPPER_MIN_VELOCITY_MILLIDEG;
+  profile.velocityIntervalUs[0] = profile.maxSpeedIntervalUs;
+  for (uint16_t raw = 1; raw < 256; raw++) {
+    int32_t num = raw <= 128 ? raw - 1 : 255 - raw;
+    int32_t den = raw <= 128 ? 127 : 126;
+    int32_t milliDegPerSec = STEPPER_MIN_VELOCITY_MILLIDEG + (int32_t)(((int64_t)span * num) / den);
+    profile.velocityIntervalUs[raw] = computeStepperIntervalUs(profile.stepsPerDegQ16, (uint32_t)milliDegPerSec, minIntervalUs);
+  }
+}
+
+struct RampProfile {
+  float minIntervalUs = 0.0f;
+  float maxStepsPerSec = 0.0f;
+  float accel = 0.0f;
+  float jerk = 0.0f;
+  float dtSec = 0.0f;
+};
+
+struct RampSim {
+  float t = 0.0f;
+  float x = 0.0f;
+  float v = 0.0f;
+  float a = 0.0f;
+  uint32_t iterations = 0;
+};
+
+static bool rampDone(const RampProfile& p, const RampSim& s) {
+  return s.v >= p.maxStepsPerSec || s.iterations >= STEPPER_RAMP_SIM_ITERATIONS * 2;
+}
+
+static void advanceRamp(const RampProfile& p, RampSim& s) {
+  if (p.jerk > 0.0f) {
+    // Start easing acceleration out once the velocity it still adds reaches the target.
+    if (s.v + (s.a * s.a) / (2.0f * p.jerk) >= p.maxStepsPerSec) {
+      s.a -= p.jerk * p.dtSec;
+      if (s.a < p.jerk * p.dtSec) s.a = p.jerk * p.dtSec;
+    } else {
+      s.a += p.jerk * p.dtSec;
+      if (s.a > p.accel) s.a = p.accel;
+    }
+  } else {
+    s.a = p.accel;
+  }
+  float v = s.v + s.a * p.dtSec;
+  if (v > p.maxStepsPerSec) v = p.maxStepsPerSec;
+  s.x += (s.v + v) * 0.5f * p.dtSec;
+  s.v = v;
+  s.t += p.dtSec;
+  s.iterations++;
+}
+
+static uint32_t toFixedInterval(const RampProfile& p, float seconds) {
+  float us = seconds * 1000000.0f;
+  if (us < p.minIntervalUs) us = p.minIntervalUs;
+  return (uint32_t)(us * (float)(1u << STEPPER_INTERVAL_FRACTION_BITS));
+}
+
+bool buildStepperRamp(StepperRamp& ramp, uint32_t stepsPerRev, uint32_t minIntervalUs, float maxDegPerSec, float accelDegPerSec2, float jerkDegPerSec3) {
+  ramp.steps = 0;
+  ramp.shift = 0;
+  ramp.length = 0;
+  if (accelDegPerSec2 <= 0.0f || stepsPerRev == 0) return false;
+
+  const float stepsPerDeg = (float)stepsPerRev / 360.0f;
+  RampProfile p;
+  p.minIntervalUs = (float)minIntervalUs;
+  p.maxStepsPerSec = maxDegPerSec * stepsPerDeg;
+  if (p.maxStepsPerSec > 1000000.0f / p.minIntervalUs) p.maxStepsPerSec = 1000000.0f / p.minIntervalUs;
+  p.accel = accelDegPerSec2 * stepsPerDeg;
+  p.jerk = jerkDegPerSec3 > 0.0f ? jerkDegPerSec3 * stepsPerDeg : 0.0f;
+  if (p.maxStepsPerSec < 1.0f) return false;
+
+  float rampSec = p.maxStepsPerSec / p.accel;
+  if (p.jerk > 0.0f) {
+    // Jerk-limited ramps that never reach full acceleration are a pure S.
+    rampSec = (p.accel * p.accel / p.jerk <= p.maxStepsPerSec) ? rampSec + p.accel / p.jerk : 2.0f * sqrtf(p.maxStepsPerSec / p.jerk);
+  }
+  p.dtSec = rampSec / (float)STEPPER_RAMP_SIM_ITERATIONS;
+
+  RampSim sizing;
+  while (!rampDone(p, sizing)) advanceRamp(p, sizing);
+  const uint32_t steps = (uint32_t)sizing.x;
+  if (steps == 0) return false;
+
+  while ((((steps - 1) >> ramp.shift) + 1) > STEPPER_RAMP_TABLE_SIZE) ramp.shift++;
+  ramp.length = (uint16_t)(((steps - 1) >> ramp.shift) + 1);
+  ramp.steps = steps;
+
+  // Refill pass: record when each bucket boundary is crossed (linearly interpolated
+  // within a time step) and store the bucket's mean interval.
+  RampSim s;
+  uint16_t bucket = 0;
+  float bucketStartSec = 0.0f;
+  while (bucket < ramp.length && !rampDone(p, s)) {
+    const float prevT = s.t;
+    const float prevX = s.x;
+    advanceRamp(p, s);
+    while (bucket < ramp.length) {
+      uint32_t bucketStart = (uint32_t)bucket << ramp.shift;
+      uint32_t bucketEnd = bucketStart + (1u << ramp.shift);
+      if (bucketEnd > steps) bucketEnd = steps;
+      if (s.x < (float)bucketEnd) break;
+      float crossSec = prevT + ((float)bucketEnd - prevX) / (s.x - prevX) * p.dtSec;
+      ramp.intervalFixed[bucket] = toFixedInterval(p, (crossSec - bucketStartSec) / (float)(bucketEnd - bucketStart));
+      bucketStartSec = crossSec;
+      bucket++;
+    }
+  }
+  const uint32_t cruiseInterval = toFixedInterval(p, 1.0f / p.maxStepsPerSec);
+  for (; bucket < ramp.length; bucket++) ramp.intervalFixed[bucket] = cruiseInterval;
+  return true;
+}
@@ -2,12 +2,19 @@
 
 #include "core/features.h"
 
-#if USE_PIXELS
-#include <Adafruit_NeoPixel.h>
+#include <atomic>
 #include <new>
-#endif
 
 #include "core/config.h"
+#include "core/pixel_color.h"
+#include "core/pixel_effects.h"
+#include "core/step_scheduler.h"
+#include "core/stepper_motion.h"
+#include "platform/gpio_batch.h"
+#include "platform/pixel_output.h"
+#include "platform/runtime_wake.h"
+#include "platform/step_pulse.h"
+#include "platform/switch_input.h"
 
 struct StepperState {
   int32_t current = 0;
@@ -15,11 +22,15 @@ struct StepperState {
   uint8_t phase = 0;
   uint32_t nextStepDueUs = 0;
   uint32_t stepIntervalUs = 1000;
+  // Acceleration state: ramp steps taken (= steps needed to brake), travel direction and
+  // the sub-microsecond remainder of the step deadline.
+  uint32_t rampLevel = 0;
+  int8_t moveDir = 0;
+  uint8_t dueFraction = 0;
   bool isMoving = false;
   bool coilsEnergized = false;
   bool velocityMode = false;
   int8_t velocityDir = 1;
-  float velocityDegPerSec = 0.0f;
   uint8_t lastVelocityRaw = 0;
   int32_t lastAbsoluteInputWithinRev = -1;
   int8_t lastStepDir = 0;
@@ -28,6 +39,24 @@ struct StepperState {
   bool storedVelocityMode = false;
   int32_t storedTargetWithinRev = 0;
   uint8_t storedSpeedRaw = 0;
+  // Copied from the config so the timer callback never reads a config snapshot: coil pins
+  // for the 4-wire driver, STEP/DIR/EN (and the RMT channel, if any) for STEP/DIR.
+  uint8_t coilPins[4] = {255, 255, 255, 255};
+  bool stepDir = false;
+  uint8_t stepPin = 255;
+  uint8_t dirPin = 255;
+  uint8_t enablePin = 255;
+  int8_t dirPinDir = 0;
+  uint8_t pulseChannel = STEP_PULSE_NO_CHANNEL;
+  // Home/e-stop switch: its edge interrupt latches homeLatched and stops stepping at once;
+  // the runtime homes the stepper, then re-arms the latch once the switch reads released.
+  // A pin without an edge interrupt is polled instead.
+  uint8_t homeSwitchPin = 255;
+  bool homeSwitchActiveLow = true;
+  bool homeSwitchPolled = false;
+  volatile bool homeLatched = false;
+  bool homeHandled = false;
+  uint32_t homeReleasedSinceMs = 0;
 };
 
 struct DcOutputState {
@@ -38,138 +67,525 @@ struct DcOutputState {
   int32_t filteredSignedDuty = 0;
   uint32_t lastRampMs = 0;
   bool initialized = false;
+  bool testOn = false;
+};
+
+// Relays and LEDs share one packed state; pin and polarity are copied from the config so
+// a DMX write never reads the snapshot.
+struct DigitalOutputState {
+  uint8_t pin = 255;
+  bool activeHigh = true;
+  bool on = false;
 };
 
-struct PixelCommand {
+#if USE_PIXELS
+// Frames are encoded through the strip's color pipeline straight into the output's back
+// buffer. dirty marks edits not yet shown; r/g/b is the last solid color. Effect strips
+// keep their last slots and render from them; effectChanged asks for a frame right away.
+struct PixelState {
+  PixelColorPipeline color;
+  PixelEffectParams effect;
+  PixelEffectState effectState;
+  uint8_t effectSlots[PIXEL_EFFECT_SLOTS];
+  uint32_t effectFrameMs = 0;
+  uint8_t output = PIXEL_OUTPUT_NONE;
   uint8_t r = 0;
   uint8_t g = 0;
   uint8_t b = 0;
+  bool testOn = false;
+  bool dirty = false;
+  bool effectChanged = false;
+};
+#endif
+
+// Runtime state lives in per-type pools carved from one arena allocated at boot; each
+// subdevice only holds a slot index into its type's pool. Capacities bound how many
+// subdevices of a type run at once (GPIO, LEDC and RMT run out well before RAM does); a
+// subdevice beyond them stays configured but idle. Relays and LEDs share the digital pool.
+enum RuntimePool : uint8_t {
+  POOL_STEPPER = 0,
+  POOL_DC = 1,
+  POOL_DIGITAL = 2,
+  POOL_PIXELS = 3,
+  POOL_NONE = 4,
+};
+
+#if defined(ESP8266)
+static constexpr uint8_t STEPPER_POOL_SIZE = 4;
+static constexpr uint8_t DC_POOL_SIZE = 4;
+static constexpr uint8_t DIGITAL_POOL_SIZE = MAX_SUBDEVICES;
+static constexpr uint8_t PIXEL_POOL_SIZE = 2;
+#else
+static constexpr uint8_t STEPPER_POOL_SIZE = 16;
+static constexpr uint8_t DC_POOL_SIZE = 16;
+static constexpr uint8_t DIGITAL_POOL_SIZE = MAX_SUBDEVICES;
+static constexpr uint8_t PIXEL_POOL_SIZE = 8;
+#endif
+static constexpr uint8_t RUNTIME_SLOT_NONE = 0xFF;
+
+struct RuntimeArena {
+  StepperState steppers[STEPPER_POOL_SIZE];
+  // Built when a stepper is configured; a stepper whose profile failed to allocate ignores
+  // commands. A null ramp means full speed at once.
+  StepperMotionProfile* stepperProfiles[STEPPER_POOL_SIZE] = {nullptr};
+  StepperRamp* stepperRamps[STEPPER_POOL_SIZE] = {nullptr};
+  DcOutputState dcOutputs[DC_POOL_SIZE];
+  DigitalOutputState digitalOutputs[DIGITAL_POOL_SIZE];
+#if USE_PIXELS
+  PixelState pixels[PIXEL_POOL_SIZE];
+#endif
 };
 
-static StepperState stepperStates[MAX_SUBDEVICES];
-static DcOutputState dcOutputStates[MAX_SUBDEVICES];
-static PixelCommand pixelCommands[MAX_SUBDEVICES];
-static bool relayStates[MAX_SUBDEVICES] = {false};
-static bool ledStates[MAX_SUBDEVICES] = {false};
-static bool dcTestStates[MAX_SUBDEVICES] = {false};
+static RuntimeArena* runtimeArena = nullptr;
+// Pool slot of each subdevice in the active snapshot; runtime side only.
+static uint8_t runtimeSlots[MAX_SUBDEVICES];
+// Set when a subdevice is (re-)initialized: its next frame is decoded in full, since the
+// frame buffers survive config edits and only mark slots that changed on the wire. One bit
+// per dispatch segment, so a strip spanning universes waits for each of them.
+static constexpr uint8_t AWAITING_ALL_SEGMENTS = 0xFF;
+static uint8_t awaitingFrame[MAX_SUBDEVICES];
+
+static StepperState& stepperState(uint8_t i) { return runtimeArena->steppers[runtimeSlots[i]]; }
+static StepperMotionProfile*& stepperProfile(uint8_t i) { return runtimeArena->stepperProfiles[runtimeSlots[i]]; }
+static StepperRamp*& stepperRamp(uint8_t i) { return runtimeArena->stepperRamps[runtimeSlots[i]]; }
+static DcOutputState& dcOutputState(uint8_t i) { return runtimeArena->dcOutputs[runtimeSlots[i]]; }
+static DigitalOutputState& digitalOutput(uint8_t i) { return runtimeArena->digitalOutputs[runtimeSlots[i]]; }
 #if USE_PIXELS
-static Adafruit_NeoPixel* pixelStrips[MAX_SUBDEVICES] = {nullptr};
-static bool pixelTestStates[MAX_SUBDEVICES] = {false};
+static PixelState& pixelState(uint8_t i) { return runtimeArena->pixels[runtimeSlots[i]]; }
+// A shown frame is still held back by an output busy with the previous one.
+static bool pixelFramesWaiting = false;
 #endif
 
-static constexpr uint8_t HALFSEQ[8][4] = {
-  {1,0,0,0}, {1,1,0,0}, {0,1,0,0}, {0,1,1,0},
-  {0,0,1,0}, {0,0,1,1}, {0,0,0,1}, {1,0,0,1},
+static RuntimePool runtimePoolFor(SubdeviceType type) {
+  switch (type) {
+    case SUBDEVICE_STEPPER: return POOL_STEPPER;
+    case SUBDEVICE_DC_MOTOR: return POOL_DC;
+    case SUBDEVICE_RELAY:
+    case SUBDEVICE_LED: return POOL_DIGITAL;
+    case SUBDEVICE_PIXELS: return USE_PIXELS ? POOL_PIXELS : POOL_NONE;
+    default: return POOL_NONE;
+  }
+}
+
+static uint8_t runtimePoolSize(RuntimePool pool) {
+  switch (pool) {
+    case POOL_STEPPER: return STEPPER_POOL_SIZE;
+    case POOL_DC: return DC_POOL_SIZE;
+    case POOL_DIGITAL: return DIGITAL_POOL_SIZE;
+    case POOL_PIXELS: return PIXEL_POOL_SIZE;
+    default: return 0;
+  }
+}
+
+static_assert(DIGITAL_POOL_SIZE <= 64 && STEPPER_POOL_SIZE <= 64 && DC_POOL_SIZE <= 64 && PIXEL_POOL_SIZE <= 64,
+              "pool occupancy is tracked in a 64-bit mask");
+
+// Coil and STEP changes are gathered under the step timer lock and committed once per
+// timer callback (DIR/EN first, STEP pulses ended after their minimum width); relay/LED
+// and output-init changes are committed at the end of each runtime pass.
+static GpioBatch stepperDirBatch;
+static GpioBatch stepperCoilBatch;
+static GpioBatch stepPulseEndBatch;
+static GpioBatch outputBatch;
+
+// A mapped pixel strip reads 3 slots per pixel and continues into the following universes
+// (170 pixels from slot 1 of each); a pixel never straddles two universes. Every other
+// subdevice reads one segment in one universe.
+static constexpr uint8_t MAX_PIXEL_SEGMENTS = 8;
+static constexpr uint16_t PIXELS_PER_UNIVERSE = SACN_UNIVERSE_SLOTS / 3;
+static_assert(MAX_PIXEL_SEGMENTS <= 8, "awaitingFrame keeps one bit per segment");
+static_assert((MAX_PIXELS_PER_STRIP + PIXELS_PER_UNIVERSE - 1) / PIXELS_PER_UNIVERSE < MAX_PIXEL_SEGMENTS,
+              "a full strip must fit its segments from any start address");
+
+// Each dispatchable subdevice has one entry per segment; only pixel pool slots add more.
+static constexpr uint8_t MAX_DISPATCH_ENTRIES = MAX_SUBDEVICES + (USE_PIXELS ? PIXEL_POOL_SIZE * (MAX_PIXEL_SEGMENTS - 1) : 0);
+
+struct SubdeviceDispatchEntry {
+  uint16_t offset = 0;
+  uint16_t width = 0;
+  // First pixel of this segment (mapped pixel strips).
+  uint16_t firstPixel = 0;
+  uint8_t index = 0;
+  uint8_t segment = 0;
 };
 
-static uint32_t computeStepperIntervalUs(uint16_t stepsPerRev, float degPerSec);
-static void applyStepperCoils(uint8_t i);
+// Entries of one universe, grouped by type: type t owns [typeFirst[t], typeFirst[t + 1]).
+struct UniverseDispatchList {
+  uint16_t universe = 0;
+  uint8_t typeFirst[SUBDEVICE_TYPE_COUNT + 1];
+};
+
+// Enabled subdevices of one type in index order, for the tick and loss passes.
+struct SubdeviceTypeList {
+  uint8_t count = 0;
+  uint8_t index[MAX_SUBDEVICES];
+};
+
+static constexpr uint8_t SNAPSHOT_NEW_RUNTIME = 0xFF;
+
+// Immutable runtime view of the subdevice config. The web/loop task edits `cfg` and
+// publishes a new snapshot with one atomic pointer swap; the runtime adopts it at the top
+// of tickSubdevices() and frees the snapshot it replaced, so runtime reads take no lock
+// and never see a half-edited subdevice.
+struct SubdeviceSnapshot {
+  uint32_t version = 0;
+  uint32_t baseVersion = 0;
+  uint8_t subdeviceCount = 0;
+  SubdeviceConfig subdevices[MAX_SUBDEVICES];
+  // Subdevice (in the base snapshot) whose runtime state each subdevice continues, or
+  // SNAPSHOT_NEW_RUNTIME to initialize it fresh. A source is carried at most once.
+  uint8_t runtimeSource[MAX_SUBDEVICES];
+  // Pool slot holding each subdevice's runtime state, or RUNTIME_SLOT_NONE (disabled, or
+  // its pool is full). Carried subdevices keep their base slot.
+  uint8_t runtimeSlot[MAX_SUBDEVICES];
+  SubdeviceDispatchEntry dispatchEntries[MAX_DISPATCH_ENTRIES];
+  UniverseDispatchList dispatchUniverses[MAX_UNIVERSES];
+  uint8_t dispatchEntryCount = 0;
+  uint8_t dispatchUniverseCount = 0;
+  // Segments left without an entry because their universe did not fit MAX_UNIVERSES.
+  uint8_t droppedSegments = 0;
+  SubdeviceTypeList activeByType[SUBDEVICE_TYPE_COUNT];
+};
+
+// Publisher side (web/loop task): newest snapshot, freed only once superseded and retired.
+static const SubdeviceSnapshot* publishedSnapshot = nullptr;
+static uint32_t snapshotVersion = 0;
+static std::atomic<SubdeviceSnapshot*> pendingSnapshot(nullptr);
+// Runtime side.
+static const SubdeviceSnapshot* activeSnapshot = nullptr;
+
+// Test/home requests from the web are queued for the runtime: (kind << 8) | index.
+static constexpr uint8_t RUNTIME_REQUEST_TEST = 1;
+static constexpr uint8_t RUNTIME_REQUEST_HOME = 2;
+static std::atomic<uint16_t> pendingRuntimeRequest(0);
+
+static const SubdeviceConfig& runtimeConfig(uint8_t i) {
+  return activeSnapshot->subdevices[i];
+}
+
+// Step events are keyed by stepper pool slot.
+static_assert(STEPPER_POOL_SIZE <= STEP_SCHEDULER_MAX_EVENTS, "every stepper slot needs a step event id");
+
+// A step that fell further behind than this (timer held off) resumes from now instead
+// of bursting the missed steps.
+static constexpr uint32_t STEPPER_MAX_CATCHUP_STEPS = 8;
+// Hardware STEP/DIR batches cover at most this much time, which bounds how late a new
+// target is picked up; a refill that finds the batch still running retries shortly.
+static constexpr uint32_t STEP_PULSE_LOOKAHEAD_US = 4000;
+static constexpr uint32_t STEP_PULSE_RETRY_US = 20;
+// DIR/EN to STEP setup time for the timer-driven STEP/DIR fallback.
+static constexpr uint32_t STEP_DIR_SETUP_US = 1;
+static constexpr uint8_t STEPPER_PIN_NONE = 255;
+// Home/e-stop switches interrupt on their edges. A held switch is re-checked every
+// STEPPER_SWITCH_HELD_POLL_MS and re-armed once it has read released for the debounce
+// time; a pin without an edge interrupt is polled every STEPPER_SWITCH_POLL_MS.
+static constexpr uint32_t STEPPER_SWITCH_POLL_MS = 1;
+static constexpr uint32_t STEPPER_SWITCH_HELD_POLL_MS = 5;
+static constexpr uint32_t STEPPER_SWITCH_DEBOUNCE_MS = 20;
+
 static void markStepperCommandReady(uint8_t i);
-static int32_t clampStepperTargetToLimits(const SubdeviceConfig& sd, int32_t target);
-static bool isStepperTimeDue(uint32_t nowUs, uint32_t dueUs);
+static int32_t clampStepperTargetToLimits(const StepperMotionProfile& profile, int32_t target);
 static void applyStepperControlCommand(uint8_t i, int32_t targetWithinRev, uint8_t speedRaw);
 static void storeStepperControlCommand(uint8_t i, int32_t targetWithinRev, uint8_t speedRaw);
 static void disableStepperForSafety(uint8_t i);
+static void rebuildSubdeviceDispatch(SubdeviceSnapshot& snapshot);
 
 
-static bool readStepperHomeSwitch(const SubdeviceConfig& sd) {
-  if (!sd.stepper.homeSwitchEnabled || sd.stepper.homeSwitchPin == 255) return false;
-  bool level = digitalRead(sd.stepper.homeSwitchPin) != 0;
-  return sd.stepper.homeSwitchActiveLow ? !level : level;
+static void setStepperCoilsLow(const SubdeviceConfig& sd) {
+  gpioBatchWrite(outputBatch, sd.stepper.in1, false);
+  gpioBatchWrite(outputBatch, sd.stepper.in2, false);
+  gpioBatchWrite(outputBatch, sd.stepper.in3, false);
+  gpioBatchWrite(outputBatch, sd.stepper.in4, false);
 }
 
-static void setStepperCoilsLow(const SubdeviceConfig& sd) {
-  digitalWrite(sd.stepper.in1, LOW);
-  digitalWrite(sd.stepper.in2, LOW);
-  digitalWrite(sd.stepper.in3, LOW);
-  digitalWrite(sd.stepper.in4, LOW);
-}
-
-static void applyStepperCoils(uint8_t i) {
-  auto& sd = cfg.subdevices[i];
-  auto& st = stepperStates[i];
-  digitalWrite(sd.stepper.in1, HALFSEQ[st.phase][0] ? HIGH : LOW);
-  digitalWrite(sd.stepper.in2, HALFSEQ[st.phase][1] ? HIGH : LOW);
-  digitalWrite(sd.stepper.in3, HALFSEQ[st.phase][2] ? HIGH : LOW);
-  digitalWrite(sd.stepper.in4, HALFSEQ[st.phase][3] ? HIGH : LOW);
+static void commitDigitalOutputs() {
+  gpioBatchCommit(outputBatch);
+}
+
+// Half-step sequence 1000,1100,0100,0110,0010,0011,0001,1001: coil c is on for
+// phases 2c-1..2c+1 (mod 8). Computed rather than table-driven so the timer callback
+// reads no flash data.
+static void STEP_TIMER_ISR_ATTR writeStepperCoils(StepperState& st) {
+  for (uint8_t c = 0; c < 4; c++) {
+    bool on = ((uint8_t)(st.phase - 2 * c + 1) & 0x07) <= 2;
+    gpioBatchWrite(stepperCoilBatch, st.coilPins[c], on);
+  }
   st.coilsEnergized = true;
 }
 
-static bool isStepperTimeDue(uint32_t nowUs, uint32_t dueUs) {
-  return (int32_t)(nowUs - dueUs) >= 0;
+// Timer-driven STEP/DIR fallback: DIR/EN go out first, STEP rises with the coil batch and
+// is ended by the flush.
+static void STEP_TIMER_ISR_ATTR pulseStepPin(StepperState& st, int8_t dir) {
+  if (!st.coilsEnergized) {
+    gpioBatchWrite(stepperDirBatch, st.enablePin, false);
+    st.coilsEnergized = true;
+  }
+  if (st.dirPinDir != dir) {
+    gpioBatchWrite(stepperDirBatch, st.dirPin, dir > 0);
+    st.dirPinDir = dir;
+  }
+  gpioBatchWrite(stepperCoilBatch, st.stepPin, true);
+  gpioBatchWrite(stepPulseEndBatch, st.stepPin, false);
+}
+
+static void STEP_TIMER_ISR_ATTR releaseStepperCoils(StepperState& st) {
+  if (st.stepDir) {
+    gpioBatchWrite(stepperCoilBatch, st.enablePin, true);
+  } else {
+    for (uint8_t c = 0; c < 4; c++) gpioBatchWrite(stepperCoilBatch, st.coilPins[c], false);
+  }
+  st.coilsEnergized = false;
+}
+
+// Scheduler flush, or called directly by runtime stops holding the step timer lock.
+static void STEP_TIMER_ISR_ATTR commitStepperOutputs() {
+  if (gpioBatchPending(stepperDirBatch)) {
+    gpioBatchCommit(stepperDirBatch);
+    delayMicroseconds(STEP_DIR_SETUP_US);
+  }
+  gpioBatchCommit(stepperCoilBatch);
+  if (gpioBatchPending(stepPulseEndBatch)) {
+    delayMicroseconds(STEP_PULSE_WIDTH_US);
+    gpioBatchCommit(stepPulseEndBatch);
+  }
+}
+
+// Picks the interval after this step from the ramp table: brake when reversing or when the
+// target is within braking distance, ease down to a slower cruise speed, otherwise climb
+// until the ramp reaches the cruise interval. A new target mid-move only changes the
+// inputs, so the stepper re-plans from its current speed instead of stopping.
+static uint32_t STEP_TIMER_ISR_ATTR planStepperInterval(StepperState& st, const StepperRamp& ramp, int8_t wantDir) {
+  const uint32_t cruise = st.stepIntervalUs << STEPPER_INTERVAL_FRACTION_BITS;
+  bool braking = wantDir != st.moveDir;
+  bool mayClimb = !braking;
+  if (!braking && !st.velocityMode) {
+    // Braking from rampLevel takes rampLevel steps, this one included.
+    uint32_t distance = (uint32_t)((st.target - st.current) * st.moveDir);
+    braking = distance <= st.rampLevel;
+    mayClimb = distance > st.rampLevel + 1;
+  }
+
+  uint32_t interval;
+  if (st.rampLevel > 0 && (braking || stepperRampInterval(ramp, st.rampLevel - 1) < cruise)) {
+    st.rampLevel--;
+    interval = stepperRampInterval(ramp, st.rampLevel);
+  } else {
+    interval = stepperRampInterval(ramp, st.rampLevel);
+    if (mayClimb && st.rampLevel < ramp.steps && interval > cruise) st.rampLevel++;
+  }
+  return interval > cruise ? interval : cruise;
+}
+
+static int8_t STEP_TIMER_ISR_ATTR stepperWantDir(const StepperState& st) {
+  if (st.velocityMode) return st.velocityDir >= 0 ? 1 : -1;
+  return st.target > st.current ? 1 : -1;
+}
+
+// Direction of the next step, or 0 once the target is reached at rest. Only a stepper at
+// rest (or one without a ramp) turns around.
+static int8_t STEP_TIMER_ISR_ATTR nextStepperDir(StepperState& st, const StepperRamp* ramp) {
+  if (!st.velocityMode && st.current == st.target && st.rampLevel == 0) return 0;
+  if (!ramp || st.rampLevel == 0) st.moveDir = stepperWantDir(st);
+  return st.moveDir;
+}
+
+// Takes one planned step in moveDir and returns the whole microseconds until the next,
+// carrying the fixed-point remainder.
+static uint32_t STEP_TIMER_ISR_ATTR advanceStepperPlan(StepperState& st, const StepperRamp* ramp) {
+  uint32_t interval = ramp ? planStepperInterval(st, *ramp, stepperWantDir(st)) : st.stepIntervalUs << STEPPER_INTERVAL_FRACTION_BITS;
+  st.current += st.moveDir;
+  st.lastStepDir = st.moveDir;
+  if (st.velocityMode) st.target = st.current;
+  interval += st.dueFraction;
+  st.dueFraction = (uint8_t)(interval & ((1u << STEPPER_INTERVAL_FRACTION_BITS) - 1));
+  return interval >> STEPPER_INTERVAL_FRACTION_BITS;
+}
+
+static void STEP_TIMER_ISR_ATTR finishStepperMove(StepperState& st) {
+  st.isMoving = false;
+  st.moveDir = 0;
+  if (st.coilsEnergized) releaseStepperCoils(st);
+}
+
+// Hardware STEP/DIR: once the previous batch has drained, plans the next one (bounded by
+// the lookahead) and comes back when its last step interval is over. The CPU only fills
+// the pulse buffer; gaps within a batch stay under the lookahead.
+static bool STEP_TIMER_ISR_ATTR refillStepPulses(StepperState& st, const StepperRamp* ramp, uint32_t nowUs, uint32_t& nextDueUs) {
+  if (!stepPulseIdle(st.pulseChannel)) {
+    nextDueUs = nowUs + STEP_PULSE_RETRY_US;
+    return true;
+  }
+  const int8_t batchDir = nextStepperDir(st, ramp);
+  if (batchDir == 0) {
+    finishStepperMove(st);
+    return false;
+  }
+
+  uint32_t intervalsUs[STEP_PULSE_MAX_BATCH];
+  uint8_t count = 0;
+  uint32_t spanUs = 0;
+  while (count < STEP_PULSE_MAX_BATCH && spanUs < STEP_PULSE_LOOKAHEAD_US && nextStepperDir(st, ramp) == batchDir) {
+    intervalsUs[count] = advanceStepperPlan(st, ramp);
+    spanUs += intervalsUs[count++];
+  }
+
+  // DIR and EN settle while the RMT call starts; the first pulse follows.
+  GpioBatch setup;
+  gpioBatchWrite(setup, st.dirPin, batchDir > 0);
+  gpioBatchWrite(setup, st.enablePin, false);
+  gpioBatchCommit(setup);
+  st.dirPinDir = batchDir;
+  st.coilsEnergized = true;
+  st.isMoving = true;
+  stepPulseSend(st.pulseChannel, intervalsUs, count);
+  nextDueUs = nowUs + spanUs;
+  return true;
+}
+
+// Timer side: emits one step (coil phase or STEP pulse) and reports when the next one is
+// due, or hands a batch to the pulse hardware. Called with the step timer lock held for
+// the stepper pool slot `slot`; touches only its StepperState and ramp table. Once the
+// target is reached at rest the following event releases the outputs and drops the stepper.
+static bool STEP_TIMER_ISR_ATTR onStepperEvent(uint8_t slot, uint32_t nowUs, uint32_t& nextDueUs) {
+  auto& st = runtimeArena->steppers[slot];
+  const StepperRamp* ramp = runtimeArena->stepperRamps[slot];
+  if (st.homeLatched) {
+    st.isMoving = false;
+    return false;
+  }
+  if (st.pulseChannel != STEP_PULSE_NO_CHANNEL) return refillStepPulses(st, ramp, nowUs, nextDueUs);
+
+  const int8_t dir = nextStepperDir(st, ramp);
+  if (dir == 0) {
+    finishStepperMove(st);
+    return false;
+  }
+
+  const uint32_t intervalUs = advanceStepperPlan(st, ramp);
+  if (st.stepDir) {
+    pulseStepPin(st, dir);
+  } else {
+    st.phase = (uint8_t)((st.phase + (dir > 0 ? 1 : 7)) & 0x07);
+    writeStepperCoils(st);
+  }
+  st.isMoving = true;
+
+  st.nextStepDueUs += intervalUs;
+  if ((int32_t)(nowUs - st.nextStepDueUs) > (int32_t)(intervalUs * STEPPER_MAX_CATCHUP_STEPS)) {
+    st.nextStepDueUs = nowUs;
+  }
+  nextDueUs = st.nextStepDueUs;
+  return true;
+}
+
+// Switch edge interrupt (either core): only the first active edge acts, later bounces hit
+// the latch. A running pulse batch is cut off here; the next step event sees the latch and
+// drops the stepper, so no further step goes out. Homing itself runs on the runtime.
+static void STEP_TIMER_ISR_ATTR onStepperHomeSwitch(void* arg, bool active) {
+  auto& st = runtimeArena->steppers[(uint8_t)(uintptr_t)arg];
+  if (!active || st.homeLatched) return;
+  stepTimerLock();
+  st.homeLatched = true;
+  stepPulseAbort(st.pulseChannel);
+  stepTimerUnlock();
+  runtimeWakeNotifyFromIsr();
 }
 
+// A stepper already in the queue keeps its step cadence; an idle one steps right away.
 static void markStepperCommandReady(uint8_t i) {
-  auto& st = stepperStates[i];
+  auto& st = stepperState(i);
+  const uint8_t slot = runtimeSlots[i];
+  stepTimerLock();
   st.isMoving = true;
-  st.nextStepDueUs = micros();
+  if (!stepSchedulerPending(slot)) {
+    st.nextStepDueUs = stepTimerNowUs();
+    st.dueFraction = 0;
+    stepSchedulerSchedule(slot, st.nextStepDueUs);
+  }
+  stepTimerUnlock();
+}
+
+// Lets an in-flight STEP/DIR batch finish so the position it already counted is true. Runs
+// without the step timer lock; the wait is bounded by the lookahead.
+static void drainStepPulses(uint8_t i) {
+  const uint8_t channel = stepperState(i).pulseChannel;
+  if (channel == STEP_PULSE_NO_CHANNEL) return;
+  stepSchedulerCancel(runtimeSlots[i]);
+  stepPulseWaitIdle(channel, STEP_PULSE_LOOKAHEAD_US * 2);
+}
+
+// Stops dead: home, DMX loss and safety stops do not ramp down.
+static void stopStepperEvents(uint8_t i) {
+  auto& st = stepperState(i);
+  stepSchedulerCancel(runtimeSlots[i]);
+  st.nextStepDueUs = 0;
+  st.dueFraction = 0;
+  st.rampLevel = 0;
+  st.moveDir = 0;
 }
 
 static void homeStepperState(uint8_t i) {
-  auto& sd = cfg.subdevices[i];
-  auto& st = stepperStates[i];
+  auto& sd = runtimeConfig(i);
+  auto& st = stepperState(i);
+  stepTimerLock();
+  stopStepperEvents(i);
+  // Homing redefines the position, so a running pulse batch is simply cut off.
+  stepPulseAbort(st.pulseChannel);
   st.current = sd.stepper.homeOffsetSteps;
   st.target = sd.stepper.homeOffsetSteps;
   st.velocityMode = false;
-  st.velocityDegPerSec = 0.0f;
-  st.stepIntervalUs = computeStepperIntervalUs(sd.stepper.stepsPerRev, sd.stepper.maxDegPerSec);
+  if (stepperProfile(i)) st.stepIntervalUs = stepperProfile(i)->maxSpeedIntervalUs;
   st.isMoving = false;
-  st.coilsEnergized = false;
   st.hasStoredCommand = false;
-  setStepperCoilsLow(sd);
+  releaseStepperCoils(st);
+  commitStepperOutputs();
+  stepTimerUnlock();
 }
 
 static void holdStepperStateOnLoss(uint8_t i) {
-  auto& sd = cfg.subdevices[i];
-  auto& st = stepperStates[i];
+  auto& st = stepperState(i);
+  drainStepPulses(i);
+  stepTimerLock();
+  stopStepperEvents(i);
   st.velocityMode = false;
-  st.velocityDegPerSec = 0.0f;
   st.target = st.current;
-  st.stepIntervalUs = computeStepperIntervalUs(sd.stepper.stepsPerRev, sd.stepper.maxDegPerSec);
+  if (stepperProfile(i)) st.stepIntervalUs = stepperProfile(i)->maxSpeedIntervalUs;
   st.isMoving = false;
-  st.coilsEnergized = false;
   st.hasStoredCommand = false;
-  setStepperCoilsLow(sd);
+  releaseStepperCoils(st);
+  commitStepperOutputs();
+  stepTimerUnlock();
 }
 
 static void disableStepperForSafety(uint8_t i) {
-  auto& sd = cfg.subdevices[i];
-  auto& st = stepperStates[i];
+  auto& st = stepperState(i);
+  drainStepPulses(i);
+  stepTimerLock();
+  stopStepperEvents(i);
   st.velocityMode = false;
-  st.velocityDegPerSec = 0.0f;
   st.target = st.current;
   st.isMoving = false;
-  st.nextStepDueUs = 0;
-  st.coilsEnergized = false;
-  setStepperCoilsLow(sd);
-}
-
-static uint32_t computeStepperIntervalUs(uint16_t stepsPerRev, float degPerSec) {
-  float stepsPerDeg = (float)stepsPerRev / 360.0f;
-  float stepsPerSec = degPerSec * stepsPerDeg;
-  if (stepsPerSec < 1.0f) stepsPerSec = 1.0f;
-  uint32_t intervalUs = (uint32_t)(1000000.0f / stepsPerSec);
-  if (intervalUs < 100) intervalUs = 100;
-  return intervalUs;
+  releaseStepperCoils(st);
+  commitStepperOutputs();
+  stepTimerUnlock();
 }
 
-static uint16_t readU16(const uint8_t* dmxSlots, uint16_t addr) {
-  uint16_t hi = dmxSlots[addr - 1];
-  uint16_t lo = dmxSlots[addr];
+static uint16_t readU16(const uint8_t* slots) {
+  uint16_t hi = slots[0];
+  uint16_t lo = slots[1];
   return (uint16_t)((hi << 8) | lo);
 }
 
-static int32_t mapPositionToSteps(uint16_t rawPosition, uint16_t rawMax, uint16_t stepsPerRev) {
+static int32_t mapPositionToSteps(uint16_t rawPosition, uint16_t rawMax, uint32_t stepsPerRev) {
   if (stepsPerRev <= 1 || rawMax == 0) return 0;
-  return (int32_t)(((uint32_t)rawPosition * (uint32_t)(stepsPerRev - 1)) / rawMax);
+  return (int32_t)(((uint64_t)rawPosition * (stepsPerRev - 1)) / rawMax);
 }
 
 static int8_t directionSign(StepperDirection dir) {
   return dir == STEPPER_DIR_CCW ? -1 : 1;
 }
 
-static int32_t computeSeekTargetSteps(const SubdeviceConfig& sd, const StepperState& st, int32_t targetWithinRev) {
-  int32_t stepsPerRev = sd.stepper.stepsPerRev;
+static int32_t computeSeekTargetSteps(const SubdeviceConfig& sd, const StepperState& st, int32_t stepsPerRev, int32_t targetWithinRev) {
   if (stepsPerRev <= 0) return st.current;
 
   int32_t currentRelative = st.current - sd.stepper.homeOffsetSteps;
@@ -206,33 +622,22 @@ static int32_t computeSeekTargetSteps(const SubdeviceConfig& sd, const StepperSt
   return st.current + (tieDirection >= 0 ? deltaCw : deltaCcw);
 }
 
-static int32_t clampStepperTargetToLimits(const SubdeviceConfig& sd, int32_t target) {
-  if (!sd.stepper.limitsEnabled) return target;
-  float stepsPerDeg = (float)sd.stepper.stepsPerRev / 360.0f;
-  int32_t minTarget = (int32_t)lroundf(sd.stepper.minDeg * stepsPerDeg) + sd.stepper.homeOffsetSteps;
-  int32_t maxTarget = (int32_t)lroundf(sd.stepper.maxDeg * stepsPerDeg) + sd.stepper.homeOffsetSteps;
-  if (target < minTarget) return minTarget;
-  if (target > maxTarget) return maxTarget;
+static int32_t clampStepperTargetToLimits(const StepperMotionProfile& profile, int32_t target) {
+  if (!profile.limitsEnabled) return target;
+  if (target < profile.minTargetSteps) return profile.minTargetSteps;
+  if (target > profile.maxTargetSteps) return profile.maxTargetSteps;
   return target;
 }
 
-static void setRelayOutput(uint8_t i, bool on) {
-  auto& sd = cfg.subdevices[i];
-  relayStates[i] = on;
-  bool level = sd.relay.activeHigh ? on : !on;
-  digitalWrite(sd.relay.pin, level ? HIGH : LOW);
-}
-
-static void setLedOutput(uint8_t i, bool on) {
-  auto& sd = cfg.subdevices[i];
-  ledStates[i] = on;
-  bool level = sd.led.activeHigh ? on : !on;
-  digitalWrite(sd.led.pin, level ? HIGH : LOW);
+static void setDigitalOutput(uint8_t i, bool on) {
+  auto& out = digitalOutput(i);
+  out.on = on;
+  gpioBatchWrite(outputBatch, out.pin, out.activeHigh ? on : !on);
 }
 
 static void setDcOutput(uint8_t i, bool forward, uint16_t duty) {
-  auto& sd = cfg.subdevices[i];
-  auto& state = dcOutputStates[i];
+  auto& sd = runtimeConfig(i);
+  auto& state = dcOutputState(i);
   if (state.currentForward == forward && state.currentDuty == duty) return;
   state.currentForward = forward;
   state.currentDuty = duty;
@@ -242,14 +647,14 @@ static void setDcOutput(uint8_t i, bool forward, uint16_t duty) {
 }
 
 static void setDcTarget(uint8_t i, bool forward, uint16_t duty) {
-  auto& state = dcOutputStates[i];
+  auto& state = dcOutputState(i);
   state.targetForward = forward;
   state.targetDuty = duty;
 }
 
 static void tickDc(uint8_t i) {
-  auto& sd = cfg.subdevices[i];
-  auto& state = dcOutputStates[i];
+  auto& sd = runtimeConfig(i);
+  auto& state = dcOutputState(i);
 
   uint32_t nowMs = millis();
   int32_t currentSignedDuty = state.currentForward ? (int32_t)state.currentDuty : -(int32_t)state.currentDuty;
@@ -293,16 +698,17 @@ static void tickDc(uint8_t i) {
 }
 
 static void applyStepperAbsoluteCommand(uint8_t i, int32_t targetWithinRev) {
-  auto& sd = cfg.subdevices[i];
-  auto& st = stepperStates[i];
+  auto& sd = runtimeConfig(i);
+  auto& st = stepperState(i);
 
   st.velocityMode = false;
-  int32_t target = computeSeekTargetSteps(sd, st, targetWithinRev);
+  int32_t target = computeSeekTargetSteps(sd, st, (int32_t)stepperProfile(i)->stepsPerRev, targetWithinRev);
   st.lastAbsoluteInputWithinRev = targetWithinRev;
-  st.target = clampStepperTargetToLimits(sd, target);
-  st.velocityDegPerSec = 0.0f;
-  st.stepIntervalUs = computeStepperIntervalUs(sd.stepper.stepsPerRev, sd.stepper.maxDegPerSec);
-  if (st.target != st.current) {
+  st.target = clampStepperTargetToLimits(*stepperProfile(i), target);
+  st.stepIntervalUs = stepperProfile(i)->maxSpeedIntervalUs;
+  // A stepper still carrying speed has to brake (and maybe come back) even when the
+  // new target is where it is right now.
+  if (st.target != st.current || st.rampLevel > 0) {
     markStepperCommandReady(i);
   } else {
     st.isMoving = false;
@@ -310,8 +716,7 @@ static void applyStepperAbsoluteCommand(uint8_t i, int32_t targetWithinRev) {
 }
 
 static void applyStepperVelocityCommand(uint8_t i, uint8_t speedRaw) {
-  auto& sd = cfg.subdevices[i];
-  auto& st = stepperStates[i];
+  auto& st = stepperState(i);
 
   if (st.velocityMode && st.lastVelocityRaw == speedRaw) return;
 
@@ -322,21 +727,8 @@ static void applyStepperVelocityCommand(uint8_t i, uint8_t speedRaw) {
   //   0      = rotation disabled (handled by caller)
   //   1-128  = CW slow -> fast
   //   129-255= CCW fast -> slow
-  float t = 0.0f;
-  if (speedRaw <= 128) {
-    st.velocityDir = 1;
-    t = ((float)speedRaw - 1.0f) / 127.0f; // 1..128 => 0..1
-  } else {
-    st.velocityDir = -1;
-    t = (255.0f - (float)speedRaw) / 126.0f; // 129..255 => 1..0
-  }
-
-  if (t < 0.0f) t = 0.0f;
-  if (t > 1.0f) t = 1.0f;
-
-  const float minDegPerSec = 1.0f;
-  st.velocityDegPerSec = minDegPerSec + (sd.stepper.maxDegPerSec - minDegPerSec) * t;
-  st.stepIntervalUs = computeStepperIntervalUs(sd.stepper.stepsPerRev, st.velocityDegPerSec);
+  st.velocityDir = speedRaw <= 128 ? 1 : -1;
+  st.stepIntervalUs = stepperProfile(i)->velocityIntervalUs[speedRaw];
   st.target = st.current;
   markStepperCommandReady(i);
 }
@@ -350,23 +742,63 @@ static void applyStepperControlCommand(uint8_t i, int32_t targetWithinRev, uint8
 }
 
 static void storeStepperControlCommand(uint8_t i, int32_t targetWithinRev, uint8_t speedRaw) {
-  auto& st = stepperStates[i];
+  auto& st = stepperState(i);
   st.hasStoredCommand = true;
   st.storedVelocityMode = speedRaw != 0;
   st.storedTargetWithinRev = targetWithinRev;
   st.storedSpeedRaw = speedRaw;
 }
-uint8_t subdeviceSlotWidth(const SubdeviceConfig& sd) {
+static bool pixelsMapped(const SubdeviceConfig& sd) {
+  return sd.type == SUBDEVICE_PIXELS && sd.pixels.mode == PIXEL_MODE_MAPPED;
+}
+
+uint16_t subdeviceSlotWidth(const SubdeviceConfig& sd) {
   switch (sd.type) {
     case SUBDEVICE_STEPPER: return sd.stepper.position16Bit ? 3 : 2;
     case SUBDEVICE_DC_MOTOR: return sd.dc.command16Bit ? 2 : 1;
     case SUBDEVICE_RELAY: return 1;
     case SUBDEVICE_LED: return 1;
-    case SUBDEVICE_PIXELS: return 3;
+    case SUBDEVICE_PIXELS:
+      if (pixelsMapped(sd)) return (uint16_t)(sd.pixels.count * 3);
+      return sd.pixels.mode == PIXEL_MODE_EFFECT ? PIXEL_EFFECT_SLOTS : 3;
     default: return 1;
   }
 }
 
+struct DispatchSegment {
+  uint16_t universe;
+  uint16_t offset;
+  uint16_t width;
+  uint16_t firstPixel;
+};
+
+// Splits the slot footprint of a subdevice into its per-universe segments and returns how
+// many there are; a subdevice without a start address has none.
+static uint8_t subdeviceSegments(const SubdeviceConfig& sd, DispatchSegment* segments) {
+  if (sd.map.startAddr < 1) return 0;
+  uint16_t offset = (uint16_t)(sd.map.startAddr - 1);
+  if (!pixelsMapped(sd)) {
+    segments[0] = {sd.map.universe, offset, subdeviceSlotWidth(sd), 0};
+    return 1;
+  }
+  uint8_t count = 0;
+  uint16_t universe = sd.map.universe;
+  for (uint16_t pixel = 0; pixel < sd.pixels.count && count < MAX_PIXEL_SEGMENTS; universe++, offset = 0) {
+    uint16_t fit = (uint16_t)((SACN_UNIVERSE_SLOTS - offset) / 3);
+    uint16_t take = (uint16_t)(sd.pixels.count - pixel) < fit ? (uint16_t)(sd.pixels.count - pixel) : fit;
+    if (take == 0) continue;
+    segments[count++] = {universe, offset, (uint16_t)(take * 3), pixel};
+    pixel = (uint16_t)(pixel + take);
+  }
+  return count;
+}
+
+uint8_t subdeviceUniverseSpan(const SubdeviceConfig& sd) {
+  DispatchSegment segments[MAX_PIXEL_SEGMENTS];
+  uint8_t count = subdeviceSegments(sd, segments);
+  return count ? count : 1;
+}
+
 String subdeviceTypeName(SubdeviceType type) {
   switch (type) {
     case SUBDEVICE_STEPPER: return "Stepper";
@@ -381,6 +813,7 @@ String subdeviceTypeName(SubdeviceType type) {
 String stepperDriverTypeName(StepperDriverType type) {
   switch (type) {
     case STEPPER_DRIVER_GENERIC: return "Generic";
+    case STEPPER_DRIVER_STEP_DIR: return "STEP/DIR";
     default: return "Unknown";
   }
 }
@@ -400,322 +833,868 @@ String pixelDriverTypeName(PixelDriverType type) {
 }
 
 static void initStepperDevice(uint8_t i) {
-  auto& sd = cfg.subdevices[i];
-  pinMode(sd.stepper.in1, OUTPUT);
-  pinMode(sd.stepper.in2, OUTPUT);
-  pinMode(sd.stepper.in3, OUTPUT);
-  pinMode(sd.stepper.in4, OUTPUT);
-  setStepperCoilsLow(sd);
-  stepperStates[i] = StepperState();
-  stepperStates[i].current = sd.stepper.homeOffsetSteps;
-  stepperStates[i].target = sd.stepper.homeOffsetSteps;
-  stepperStates[i].stepIntervalUs = computeStepperIntervalUs(sd.stepper.stepsPerRev, sd.stepper.maxDegPerSec);
-  stepperStates[i].isMoving = false;
-  stepperStates[i].coilsEnergized = false;
-  stepperStates[i].safetyEnabled = true;
-  stepperStates[i].hasStoredCommand = false;
+  auto& sd = runtimeConfig(i);
+  const bool stepDir = sd.stepper.driver == STEPPER_DRIVER_STEP_DIR;
+  if (stepDir) {
+    pinMode(sd.stepper.stepPin, OUTPUT);
+    pinMode(sd.stepper.dirPin, OUTPUT);
+    gpioBatchWrite(outputBatch, sd.stepper.stepPin, false);
+    if (sd.stepper.enablePin != STEPPER_PIN_NONE) {
+      pinMode(sd.stepper.enablePin, OUTPUT);
+      gpioBatchWrite(outputBatch, sd.stepper.enablePin, true);
+    }
+  } else {
+    pinMode(sd.stepper.in1, OUTPUT);
+    pinMode(sd.stepper.in2, OUTPUT);
+    pinMode(sd.stepper.in3, OUTPUT);
+    pinMode(sd.stepper.in4, OUTPUT);
+    setStepperCoilsLow(sd);
+  }
+  stepSchedulerBegin(onStepperEvent, commitStepperOutputs);
+  stepSchedulerCancel(runtimeSlots[i]);
+  auto& st = stepperState(i);
+  switchInputDetach(st.homeSwitchPin);
+  stepPulseDetach(st.pulseChannel);
+  st = StepperState();
+  if (stepDir) st.pulseChannel = stepPulseAttach(sd.stepper.stepPin);
+  // Microsteps only scale STEP/DIR drivers; pulse trains from the RMT allow the faster rate.
+  const uint32_t stepsPerRev = (uint32_t)sd.stepper.stepsPerRev * (stepDir ? sd.stepper.microsteps : 1);
+  const uint32_t minIntervalUs = st.pulseChannel != STEP_PULSE_NO_CHANNEL ? STEPPER_STEP_DIR_MIN_INTERVAL_US : STEPPER_COIL_MIN_INTERVAL_US;
+
+  // The event is cancelled, so the timer no longer reads this slot's tables. The config's
+  // float degrees are converted here once; commands only use the integer profile.
+  auto& profile = stepperProfile(i);
+  delete profile;
+  profile = new (std::nothrow) StepperMotionProfile();
+  if (profile) {
+    buildStepperMotionProfile(*profile, stepsPerRev, minIntervalUs, (int32_t)lroundf(sd.stepper.maxDegPerSec * 1000.0f),
+                              sd.stepper.limitsEnabled, (int32_t)lroundf(sd.stepper.minDeg * 1000.0f),
+                              (int32_t)lroundf(sd.stepper.maxDeg * 1000.0f), sd.stepper.homeOffsetSteps);
+  }
+  delete stepperRamp(i);
+  stepperRamp(i) = nullptr;
+  if (sd.stepper.accelDegPerSec2 > 0.0f) {
+    StepperRamp* ramp = new (std::nothrow) StepperRamp();
+    if (ramp && buildStepperRamp(*ramp, stepsPerRev, minIntervalUs, sd.stepper.maxDegPerSec, sd.stepper.accelDegPerSec2, sd.stepper.jerkDegPerSec3)) {
+      stepperRamp(i) = ramp;
+    } else {
+      delete ramp;
+    }
+  }
+  st.stepDir = stepDir;
+  if (stepDir) {
+    st.stepPin = sd.stepper.stepPin;
+    st.dirPin = sd.stepper.dirPin;
+    st.enablePin = sd.stepper.enablePin;
+  } else {
+    st.coilPins[0] = sd.stepper.in1;
+    st.coilPins[1] = sd.stepper.in2;
+    st.coilPins[2] = sd.stepper.in3;
+    st.coilPins[3] = sd.stepper.in4;
+  }
+  st.current = sd.stepper.homeOffsetSteps;
+  st.target = sd.stepper.homeOffsetSteps;
+  if (profile) st.stepIntervalUs = profile->maxSpeedIntervalUs;
+  st.isMoving = false;
+  st.coilsEnergized = false;
+  st.safetyEnabled = true;
+  st.hasStoredCommand = false;
   if (sd.stepper.homeSwitchEnabled && sd.stepper.homeSwitchPin != 255) {
-    pinMode(sd.stepper.homeSwitchPin, sd.stepper.homeSwitchActiveLow ? INPUT_PULLUP : INPUT);
+    st.homeSwitchPin = sd.stepper.homeSwitchPin;
+    st.homeSwitchActiveLow = sd.stepper.homeSwitchActiveLow;
+    st.homeSwitchPolled = !switchInputAttach(st.homeSwitchPin, st.homeSwitchActiveLow, onStepperHomeSwitch,
+                                             (void*)(uintptr_t)runtimeSlots[i]);
+    // A switch already engaged gives no edge.
+    if (switchInputActive(st.homeSwitchPin, st.homeSwitchActiveLow)) st.homeLatched = true;
   }
 }
 
 static void initDcDevice(uint8_t i) {
-  auto& sd = cfg.subdevices[i];
+  auto& sd = runtimeConfig(i);
   pinMode(sd.dc.dirPin, OUTPUT);
   digitalWrite(sd.dc.dirPin, LOW);
   ledcSetup(sd.dc.pwmChannel, sd.dc.pwmHz, sd.dc.pwmBits);
   ledcAttachPin(sd.dc.pwmPin, sd.dc.pwmChannel);
   ledcWrite(sd.dc.pwmChannel, 0);
-  dcOutputStates[i] = DcOutputState();
-  dcOutputStates[i].initialized = false;
-  dcTestStates[i] = false;
+  dcOutputState(i) = DcOutputState();
+  dcOutputState(i).initialized = false;
 }
 
-static void initRelayDevice(uint8_t i) {
-  auto& sd = cfg.subdevices[i];
-  pinMode(sd.relay.pin, OUTPUT);
-  setRelayOutput(i, false);
+static void initDigitalOutput(uint8_t i, uint8_t pin, bool activeHigh) {
+  pinMode(pin, OUTPUT);
+  auto& out = digitalOutput(i);
+  out = DigitalOutputState();
+  out.pin = pin;
+  out.activeHigh = activeHigh;
+  setDigitalOutput(i, false);
 }
 
-static void initLedDevice(uint8_t i) {
-  auto& sd = cfg.subdevices[i];
-  pinMode(sd.led.pin, OUTPUT);
-  setLedOutput(i, false);
+#if USE_PIXELS
+static void buildPixelColor(uint8_t i) {
+  const auto& sd = runtimeConfig(i);
+  buildPixelColorPipeline(pixelState(i).color, sd.pixels.colorOrder, sd.pixels.brightness, sd.pixels.gamma);
 }
 
-#if USE_PIXELS
+// Encodes the color once and repeats its wire bytes over the strip.
+static void fillPixels(uint8_t i, uint8_t r, uint8_t g, uint8_t b) {
+  auto& px = pixelState(i);
+  uint8_t* frame = pixelOutputBuffer(px.output);
+  if (!frame) return;
+  const uint8_t rgb[3] = {r, g, b};
+  uint8_t wire[PIXEL_OUTPUT_BYTES_PER_PIXEL];
+  encodePixelColor(px.color, wire, rgb);
+  const uint16_t count = runtimeConfig(i).pixels.count;
+  for (uint16_t p = 0; p < count; p++, frame += PIXEL_OUTPUT_BYTES_PER_PIXEL) memcpy(frame, wire, sizeof(wire));
+  px.dirty = true;
+}
+
+// A strip beyond the free outputs stays configured but dark, like a full pool.
 static void initPixelDevice(uint8_t i) {
-  auto& sd = cfg.subdevices[i];
-  if (pixelStrips[i]) {
-    delete pixelStrips[i];
-    pixelStrips[i] = nullptr;
-  }
-  if (sd.pixels.count == 0) return;
-
-  pixelStrips[i] = new (std::nothrow) Adafruit_NeoPixel(sd.pixels.count, sd.pixels.pin, NEO_GRB + NEO_KHZ800);
-  if (!pixelStrips[i]) return;
-  pixelStrips[i]->begin();
-  pixelStrips[i]->setBrightness(sd.pixels.brightness);
-  pixelStrips[i]->clear();
-  pixelStrips[i]->show();
-  pixelCommands[i] = PixelCommand();
-  pixelTestStates[i] = false;
+  auto& sd = runtimeConfig(i);
+  auto& px = pixelState(i);
+  pixelOutputDetach(px.output);
+  px = PixelState();
+  px.effectState.seed = sd.pixels.pin;
+  buildPixelColor(i);
+  px.output = pixelOutputAttach(sd.pixels.pin, sd.pixels.count);
+  // The cleared buffer goes out on the next tick.
+  px.dirty = px.output != PIXEL_OUTPUT_NONE;
 }
 #endif
 
-static void clearSubdeviceRuntimeState() {
-  for (uint8_t i = 0; i < MAX_SUBDEVICES; i++) {
-    stepperStates[i] = StepperState();
-    dcOutputStates[i] = DcOutputState();
-    pixelCommands[i] = PixelCommand();
-    relayStates[i] = false;
-    ledStates[i] = false;
-    dcTestStates[i] = false;
+// Returns a pool slot to its defaults, freeing what the previous owner allocated.
+static void releaseRuntimeSlot(RuntimePool pool, uint8_t slot) {
+  switch (pool) {
+    case POOL_STEPPER:
+      // Events are keyed by slot: once this one is out of the queue the timer no longer
+      // touches the slot.
+      stepSchedulerCancel(slot);
+      switchInputDetach(runtimeArena->steppers[slot].homeSwitchPin);
+      stepPulseDetach(runtimeArena->steppers[slot].pulseChannel);
+      runtimeArena->steppers[slot] = StepperState();
+      delete runtimeArena->stepperRamps[slot];
+      runtimeArena->stepperRamps[slot] = nullptr;
+      delete runtimeArena->stepperProfiles[slot];
+      runtimeArena->stepperProfiles[slot] = nullptr;
+      break;
+    case POOL_DC: runtimeArena->dcOutputs[slot] = DcOutputState(); break;
+    case POOL_DIGITAL: runtimeArena->digitalOutputs[slot] = DigitalOutputState(); break;
 #if USE_PIXELS
-    if (pixelStrips[i]) {
-      delete pixelStrips[i];
-      pixelStrips[i] = nullptr;
-    }
-    pixelTestStates[i] = false;
+    case POOL_PIXELS:
+      pixelOutputDetach(runtimeArena->pixels[slot].output);
+      runtimeArena->pixels[slot] = PixelState();
+      break;
 #endif
+    default: break;
   }
 }
 
-void initSubdevices() {
-  clearSubdeviceRuntimeState();
+static void initRuntimeDevice(uint8_t i) {
+  const auto& sd = runtimeConfig(i);
+  if (!sd.enabled || runtimeSlots[i] == RUNTIME_SLOT_NONE) return;
+  switch (sd.type) {
+    case SUBDEVICE_STEPPER: initStepperDevice(i); break;
+    case SUBDEVICE_DC_MOTOR: initDcDevice(i); break;
+    case SUBDEVICE_RELAY: initDigitalOutput(i, sd.relay.pin, sd.relay.activeHigh); break;
+    case SUBDEVICE_LED: initDigitalOutput(i, sd.led.pin, sd.led.activeHigh); break;
+    case SUBDEVICE_PIXELS:
+#if USE_PIXELS
+      initPixelDevice(i);
+#endif
+      break;
+    default: break;
+  }
+}
 
-  for (uint8_t i = 0; i < cfg.subdeviceCount && i < MAX_SUBDEVICES; i++) {
-    if (!cfg.subdevices[i].enabled) continue;
-    switch (cfg.subdevices[i].type) {
-      case SUBDEVICE_STEPPER: initStepperDevice(i); break;
-      case SUBDEVICE_DC_MOTOR: initDcDevice(i); break;
-      case SUBDEVICE_RELAY: initRelayDevice(i); break;
-      case SUBDEVICE_LED: initLedDevice(i); break;
-      case SUBDEVICE_PIXELS:
+// Config diff for a carried subdevice: true when `to` changes anything its runtime state
+// was built from (pins, drivers, PWM setup, motion tables, strip length). Fields the
+// runtime reads from the active snapshot on every decode or tick (name, DMX mapping, DC
+// deadband/ramp/limits, stepper seek and position modes, pixel mode and color) are picked up
+// live, so such an edit keeps the device running.
+static bool subdeviceNeedsReinit(const SubdeviceConfig& from, const SubdeviceConfig& to) {
+  if (from.type != to.type || from.enabled != to.enabled) return true;
+  switch (to.type) {
+    case SUBDEVICE_STEPPER: {
+      const auto& a = from.stepper;
+      const auto& b = to.stepper;
+      return a.driver != b.driver || a.in1 != b.in1 || a.in2 != b.in2 || a.in3 != b.in3 || a.in4 != b.in4 ||
+             a.stepPin != b.stepPin || a.dirPin != b.dirPin || a.enablePin != b.enablePin ||
+             a.microsteps != b.microsteps || a.stepsPerRev != b.stepsPerRev || a.maxDegPerSec != b.maxDegPerSec ||
+             a.accelDegPerSec2 != b.accelDegPerSec2 || a.jerkDegPerSec3 != b.jerkDegPerSec3 ||
+             a.minDeg != b.minDeg || a.maxDeg != b.maxDeg || a.homeOffsetSteps != b.homeOffsetSteps ||
+             a.limitsEnabled != b.limitsEnabled || a.homeSwitchEnabled != b.homeSwitchEnabled ||
+             a.homeSwitchPin != b.homeSwitchPin || a.homeSwitchActiveLow != b.homeSwitchActiveLow;
+    }
+    case SUBDEVICE_DC_MOTOR: {
+      const auto& a = from.dc;
+      const auto& b = to.dc;
+      return a.driver != b.driver || a.dirPin != b.dirPin || a.pwmPin != b.pwmPin ||
+             a.pwmChannel != b.pwmChannel || a.pwmHz != b.pwmHz || a.pwmBits != b.pwmBits;
+    }
+    case SUBDEVICE_RELAY: return from.relay.pin != to.relay.pin || from.relay.activeHigh != to.relay.activeHigh;
+    case SUBDEVICE_LED: return from.led.pin != to.led.pin || from.led.activeHigh != to.led.activeHigh;
+    case SUBDEVICE_PIXELS:
+      return from.pixels.driver != to.pixels.driver || from.pixels.pin != to.pixels.pin || from.pixels.count != to.pixels.count;
+    default: return true;
+  }
+}
+
+// A carried subdevice keeps its state; only the live-tunable fields that are cached in
+// that state are refreshed. A carried stepper's step event stays queued in its slot, so a
+// move keeps its cadence across the edit.
+static void retuneRuntimeDevice(uint8_t i, const SubdeviceConfig& from) {
+  if (runtimeSlots[i] == RUNTIME_SLOT_NONE) return;
 #if USE_PIXELS
-        initPixelDevice(i);
+  const auto& sd = runtimeConfig(i);
+  if (sd.type == SUBDEVICE_PIXELS &&
+      (sd.pixels.brightness != from.pixels.brightness || sd.pixels.gamma != from.pixels.gamma ||
+       sd.pixels.colorOrder != from.pixels.colorOrder || sd.pixels.mode != from.pixels.mode)) {
+    // The buffer holds encoded colors: a solid strip refills from its last color, an effect
+    // renders again, a mapped one is re-encoded from its next frame.
+    buildPixelColor(i);
+    awaitingFrame[i] = AWAITING_ALL_SEGMENTS;
+    auto& px = pixelState(i);
+    if (sd.pixels.mode == PIXEL_MODE_SOLID) fillPixels(i, px.r, px.g, px.b);
+    if (sd.pixels.mode == PIXEL_MODE_EFFECT) px.effectChanged = true;
+  }
+#else
+  (void)from;
 #endif
+}
+
+// Carried subdevices keep their base pool slot; the others take the lowest free slot of
+// their type's pool. A carry that cannot keep its slot, or whose config diff needs a
+// re-init, is downgraded to a fresh init.
+static void assignRuntimeSlots(SubdeviceSnapshot& next, const SubdeviceSnapshot* base) {
+  uint64_t used[POOL_NONE] = {0};
+  bool sourceTaken[MAX_SUBDEVICES] = {false};
+  for (uint8_t i = 0; i < next.subdeviceCount; i++) {
+    next.runtimeSlot[i] = RUNTIME_SLOT_NONE;
+    uint8_t source = next.runtimeSource[i];
+    if (source == SNAPSHOT_NEW_RUNTIME) continue;
+    RuntimePool pool = runtimePoolFor(next.subdevices[i].type);
+    bool keep = base && source < base->subdeviceCount && !sourceTaken[source] && pool != POOL_NONE &&
+                runtimePoolFor(base->subdevices[source].type) == pool && base->runtimeSlot[source] != RUNTIME_SLOT_NONE &&
+                !subdeviceNeedsReinit(base->subdevices[source], next.subdevices[i]);
+    if (!keep) {
+      next.runtimeSource[i] = SNAPSHOT_NEW_RUNTIME;
+      continue;
+    }
+    sourceTaken[source] = true;
+    next.runtimeSlot[i] = base->runtimeSlot[source];
+    used[pool] |= 1ull << next.runtimeSlot[i];
+  }
+  for (uint8_t i = 0; i < next.subdeviceCount; i++) {
+    const auto& sd = next.subdevices[i];
+    RuntimePool pool = runtimePoolFor(sd.type);
+    if (next.runtimeSource[i] != SNAPSHOT_NEW_RUNTIME || !sd.enabled || pool == POOL_NONE) continue;
+    for (uint8_t slot = 0; slot < runtimePoolSize(pool); slot++) {
+      if (used[pool] & (1ull << slot)) continue;
+      used[pool] |= 1ull << slot;
+      next.runtimeSlot[i] = slot;
+      break;
+    }
+  }
+}
+
+// Builds a snapshot of `cfg` off to the side and swaps it in as the pending one. A pending
+// snapshot the runtime never picked up is freed here; its successor is then based on a
+// version the runtime does not run, so it falls back to a full re-init on adoption.
+static void publishSubdeviceSnapshot(const uint8_t* runtimeSource) {
+  if (!runtimeArena) return;
+  SubdeviceSnapshot* next = new (std::nothrow) SubdeviceSnapshot();
+  if (!next) return;
+
+  next->version = ++snapshotVersion;
+  next->baseVersion = publishedSnapshot ? publishedSnapshot->version : 0;
+  next->subdeviceCount = cfg.subdeviceCount < MAX_SUBDEVICES ? cfg.subdeviceCount : MAX_SUBDEVICES;
+  for (uint8_t i = 0; i < next->subdeviceCount; i++) {
+    next->subdevices[i] = cfg.subdevices[i];
+    next->runtimeSource[i] = runtimeSource ? runtimeSource[i] : SNAPSHOT_NEW_RUNTIME;
+  }
+  assignRuntimeSlots(*next, publishedSnapshot);
+  rebuildSubdeviceDispatch(*next);
+
+  publishedSnapshot = next;
+  SubdeviceSnapshot* superseded = pendingSnapshot.exchange(next, std::memory_order_acq_rel);
+  delete superseded;
+  runtimeWakeNotify();
+}
+
+// Runtime quiescent point: no decode or tick is in flight, so runtime state can be
+// remapped to the new snapshot and the old snapshot reclaimed.
+static void adoptPendingSnapshot() {
+  if (!pendingSnapshot.load(std::memory_order_acquire)) return;
+  SubdeviceSnapshot* next = pendingSnapshot.exchange(nullptr, std::memory_order_acq_rel);
+  if (!next) return;
+
+  const SubdeviceSnapshot* previous = activeSnapshot;
+  bool carryState = previous && next->baseVersion == previous->version;
+  bool carried[MAX_SUBDEVICES] = {false};
+  if (carryState) {
+    for (uint8_t i = 0; i < next->subdeviceCount; i++) {
+      uint8_t source = next->runtimeSource[i];
+      if (source == SNAPSHOT_NEW_RUNTIME) continue;
+      if (source >= previous->subdeviceCount || carried[source]) {
+        carryState = false;
         break;
-      default: break;
+      }
+      carried[source] = true;
+    }
+    if (!carryState) memset(carried, 0, sizeof(carried));
+  }
+
+  // The step timer only indexes pool slots, never subdevice indices, so carried steppers
+  // keep stepping through the remap. Released slots cancel their event before their state
+  // is reset, and re-initialized steppers cancel theirs in initStepperDevice().
+  for (uint8_t k = 0; previous && k < previous->subdeviceCount; k++) {
+    if (carried[k] || previous->runtimeSlot[k] == RUNTIME_SLOT_NONE) continue;
+    releaseRuntimeSlot(runtimePoolFor(previous->subdevices[k].type), previous->runtimeSlot[k]);
+  }
+  for (uint8_t i = 0; i < next->subdeviceCount; i++) runtimeSlots[i] = next->runtimeSlot[i];
+
+  uint8_t carriedAwaiting[MAX_SUBDEVICES];
+  memcpy(carriedAwaiting, awaitingFrame, sizeof(carriedAwaiting));
+  activeSnapshot = next;
+  for (uint8_t i = 0; i < next->subdeviceCount; i++) {
+    if (!carryState || next->runtimeSource[i] == SNAPSHOT_NEW_RUNTIME) {
+      initRuntimeDevice(i);
+      awaitingFrame[i] = AWAITING_ALL_SEGMENTS;
+    } else {
+      awaitingFrame[i] = carriedAwaiting[next->runtimeSource[i]];
+      retuneRuntimeDevice(i, previous->subdevices[next->runtimeSource[i]]);
     }
   }
+  delete previous;
 }
 
-static void tickStepper(uint8_t i) {
-  auto& sd = cfg.subdevices[i];
-  auto& st = stepperStates[i];
+static void runRuntimeRequest(uint8_t kind, uint8_t index);
+
+static void serviceRuntimeRequests() {
+  adoptPendingSnapshot();
+  if (!pendingRuntimeRequest.load(std::memory_order_acquire)) return;
+  uint16_t request = pendingRuntimeRequest.exchange(0, std::memory_order_acq_rel);
+  if (request != 0) runRuntimeRequest((uint8_t)(request >> 8), (uint8_t)(request & 0xFF));
+}
+
+#if USE_PIXELS
+// Strips that get pool slots: the first PIXEL_POOL_SIZE enabled ones.
+static void configuredPixels(uint32_t& pixels, uint16_t& longest) {
+  pixels = 0;
+  longest = 0;
+  uint8_t strips = 0;
+  for (uint8_t i = 0; i < cfg.subdeviceCount && i < MAX_SUBDEVICES && strips < PIXEL_POOL_SIZE; i++) {
+    const auto& sd = cfg.subdevices[i];
+    if (!sd.enabled || sd.type != SUBDEVICE_PIXELS) continue;
+    strips++;
+    pixels += sd.pixels.count;
+    if (sd.pixels.count > longest) longest = sd.pixels.count;
+  }
+}
+
+// Pixel frame memory is reserved for the strips configured at boot plus cfg.pixelHeadroom,
+// so live edits never allocate it.
+static void reservePixelOutputs() {
+  uint32_t pixels;
+  uint16_t longest;
+  configuredPixels(pixels, longest);
+  uint32_t lane = (uint32_t)longest + cfg.pixelHeadroom;
+  if (lane > MAX_PIXELS_PER_STRIP) lane = MAX_PIXELS_PER_STRIP;
+  pixelOutputReserve(pixels + cfg.pixelHeadroom, (uint16_t)lane);
+}
+#endif
+
+bool subdevicePixelsFit() {
+#if USE_PIXELS
+  uint32_t pixels;
+  uint16_t longest;
+  configuredPixels(pixels, longest);
+  return pixelOutputFits(pixels, longest);
+#else
+  return true;
+#endif
+}
+
+void initSubdevices() {
+  // The arena is sized once here and never moves, so the step timer can index it freely.
+  if (!runtimeArena) runtimeArena = new (std::nothrow) RuntimeArena();
+#if USE_PIXELS
+  reservePixelOutputs();
+#endif
+  publishSubdeviceSnapshot(nullptr);
+}
 
-  if (readStepperHomeSwitch(sd)) {
+void publishSubdeviceChanges() {
+  uint8_t runtimeSource[MAX_SUBDEVICES];
+  for (uint8_t i = 0; i < MAX_SUBDEVICES; i++) {
+    bool carried = publishedSnapshot && i < publishedSnapshot->subdeviceCount;
+    runtimeSource[i] = carried ? i : SNAPSHOT_NEW_RUNTIME;
+  }
+  publishSubdeviceSnapshot(runtimeSource);
+}
+
+// Steps are emitted by the step scheduler; the runtime tick only finishes a latched home
+// switch: homes the stepper once, holds it while the switch stays engaged and re-arms the
+// latch after STEPPER_SWITCH_DEBOUNCE_MS released, which also swallows contact bounce.
+static void tickStepper(uint8_t i) {
+  auto& st = stepperState(i);
+  // Interrupt-driven switches are only read again once their edge has latched.
+  if (!st.homeLatched && !st.homeSwitchPolled) return;
+  const bool engaged = st.homeSwitchPin != STEPPER_PIN_NONE && switchInputActive(st.homeSwitchPin, st.homeSwitchActiveLow);
+  if (st.homeSwitchPolled && engaged) st.homeLatched = true;
+  if (!st.homeLatched) return;
+  if (!st.homeHandled) {
     homeStepperState(i);
+    st.homeHandled = true;
+    st.homeReleasedSinceMs = 0;
+  }
+  if (engaged) {
+    st.homeReleasedSinceMs = 0;
     return;
   }
-
-  uint32_t nowUs = micros();
-  if (!st.velocityMode && st.current == st.target) {
-    st.isMoving = false;
-    if (st.coilsEnergized) {
-      setStepperCoilsLow(sd);
-      st.coilsEnergized = false;
-    }
+  const uint32_t nowMs = millis();
+  if (st.homeReleasedSinceMs == 0) {
+    st.homeReleasedSinceMs = nowMs | 1;
     return;
   }
+  if ((uint32_t)(nowMs - st.homeReleasedSinceMs) < STEPPER_SWITCH_DEBOUNCE_MS) return;
+  st.homeHandled = false;
+  st.homeLatched = false;
+  // An edge in the release window hit the latch; a switch engaged again latches here.
+  if (switchInputActive(st.homeSwitchPin, st.homeSwitchActiveLow)) st.homeLatched = true;
+}
+
+static void decodeDcSlots(uint8_t i, const uint8_t* slots) {
+  auto& sd = runtimeConfig(i);
+  uint16_t raw = sd.dc.command16Bit
+                 ? readU16(slots)
+                 : (uint16_t)(slots[0] * 257U);
+  int16_t signedCmd = (int16_t)((int32_t)raw - 32768);
+  int32_t v = signedCmd;
+  if (abs(v) <= sd.dc.deadband || raw == 0) v = 0;
+  if (v == 0) { setDcTarget(i, true, 0); return; }
+  bool fwd = (v > 0);
+  uint32_t mag = (uint32_t)abs(v);
+  uint32_t out = (mag * sd.dc.maxPwm) / 32768;
+  if (out < 1) out = 1;
+  if (out > sd.dc.maxPwm) out = sd.dc.maxPwm;
+  setDcTarget(i, fwd, (uint16_t)out);
+}
+
+static void applyStepperSlots(uint8_t i, const uint8_t* slots) {
+  auto& sd = runtimeConfig(i);
+  auto& st = stepperState(i);
+  uint8_t controlRaw = 0;
+  int32_t targetWithinRev = 0;
+
+  if (sd.stepper.position16Bit) {
+    uint16_t positionRaw16 = readU16(slots);
+    controlRaw = slots[2];
+    targetWithinRev = mapPositionToSteps(positionRaw16, 65535, stepperProfile(i)->stepsPerRev);
+  } else {
+    uint8_t positionRaw8 = slots[0];
+    controlRaw = slots[1];
+    targetWithinRev = mapPositionToSteps(positionRaw8, 255, stepperProfile(i)->stepsPerRev);
+  }
 
-  if (st.nextStepDueUs == 0) st.nextStepDueUs = nowUs;
+  bool safetyEnabled = (controlRaw & 0x01) != 0;
+  uint8_t speedRaw = controlRaw & 0xFE;
 
-  uint8_t maxStepsThisTick = 8;
-  uint8_t stepsDone = 0;
-  while (isStepperTimeDue(nowUs, st.nextStepDueUs) && stepsDone < maxStepsThisTick) {
-    uint32_t intervalUs = st.stepIntervalUs;
+  if (!safetyEnabled) {
+    st.safetyEnabled = false;
+    storeStepperControlCommand(i, targetWithinRev, speedRaw);
+    disableStepperForSafety(i);
+    return;
+  }
 
-    if (st.velocityMode) {
-      if (st.velocityDir >= 0) {
-        st.current++;
-        st.phase = (st.phase + 1) & 0x07;
-        st.lastStepDir = 1;
-      } else {
-        st.current--;
-        st.phase = (st.phase + 7) & 0x07;
-        st.lastStepDir = -1;
-      }
-      st.target = st.current;
-    } else if (st.target > st.current) {
-      st.current++;
-      st.phase = (st.phase + 1) & 0x07;
-      st.lastStepDir = 1;
+  bool wasSafetyDisabled = !st.safetyEnabled;
+  st.safetyEnabled = true;
+  if (wasSafetyDisabled && st.hasStoredCommand) {
+    if (st.storedVelocityMode) {
+      applyStepperVelocityCommand(i, st.storedSpeedRaw);
     } else {
-      st.current--;
-      st.phase = (st.phase + 7) & 0x07;
-      st.lastStepDir = -1;
+      applyStepperAbsoluteCommand(i, st.storedTargetWithinRev);
     }
+    st.hasStoredCommand = false;
+    return;
+  }
 
-    applyStepperCoils(i);
-    st.isMoving = true;
+  applyStepperControlCommand(i, targetWithinRev, speedRaw);
+}
+
+// Commands update state the step timer reads, so they apply under the step timer lock.
+static void decodeStepperSlots(uint8_t i, const uint8_t* slots) {
+  if (!stepperProfile(i) || stepperState(i).homeLatched) return;
+  stepTimerLock();
+  applyStepperSlots(i, slots);
+  stepTimerUnlock();
+}
 
-    st.nextStepDueUs += intervalUs;
-    stepsDone++;
-    nowUs = micros();
+static void decodeDigitalSlots(uint8_t i, const uint8_t* slots) {
+  setDigitalOutput(i, slots[0] >= 128);
+}
+
+#if USE_PIXELS
+// Solid strips refill only when the color changes; a mapped segment rewrites its pixels.
+// Either way the frame is shown by the next tick, once every universe of this pass is in.
+// Effect strips only take new parameters; the tick renders them.
+static void decodePixelSlots(const SubdeviceDispatchEntry& entry, const uint8_t* slots) {
+  const uint8_t i = entry.index;
+  auto& px = pixelState(i);
+  uint8_t* frame = pixelOutputBuffer(px.output);
+  if (!frame) return;
+  if (runtimeConfig(i).pixels.mode == PIXEL_MODE_EFFECT) {
+    if (memcmp(px.effectSlots, slots, PIXEL_EFFECT_SLOTS) == 0) return;
+    memcpy(px.effectSlots, slots, PIXEL_EFFECT_SLOTS);
+    decodePixelEffectParams(slots, px.effect);
+    px.effectChanged = true;
+    return;
+  }
+  if (runtimeConfig(i).pixels.mode == PIXEL_MODE_MAPPED) {
+    frame += entry.firstPixel * PIXEL_OUTPUT_BYTES_PER_PIXEL;
+    for (uint16_t k = 0; k < entry.width; k += 3) encodePixelColor(px.color, frame + k, slots + k);
+    px.dirty = true;
+    return;
   }
+  uint8_t r = slots[0];
+  uint8_t g = slots[1];
+  uint8_t b = slots[2];
+  if (px.r == r && px.g == g && px.b == b) return;
+  px.r = r;
+  px.g = g;
+  px.b = b;
+  fillPixels(i, r, g, b);
+}
 
-  if (stepsDone == 0 && !st.velocityMode && st.current == st.target) {
-    st.isMoving = false;
+// An effect renders every PIXEL_EFFECT_FRAME_MS while it animates, and at once after its
+// parameters (or color settings) change. A stalled pass resumes the animation where it
+// stopped instead of jumping ahead.
+static constexpr uint32_t PIXEL_EFFECT_MAX_STEP_MS = 4 * PIXEL_EFFECT_FRAME_MS;
+
+static void renderEffectFrame(uint8_t i) {
+  auto& px = pixelState(i);
+  const uint32_t nowMs = millis();
+  uint32_t elapsedMs = nowMs - px.effectFrameMs;
+  if (!px.effectChanged && (!pixelEffectAnimated(px.effect) || elapsedMs < PIXEL_EFFECT_FRAME_MS)) return;
+  uint8_t* frame = pixelOutputBuffer(px.output);
+  if (!frame) return;
+  if (elapsedMs > PIXEL_EFFECT_MAX_STEP_MS) elapsedMs = PIXEL_EFFECT_MAX_STEP_MS;
+  const uint16_t count = runtimeConfig(i).pixels.count;
+  renderPixelEffect(px.effect, px.effectState, elapsedMs, frame, count);
+  encodePixelFrame(px.color, frame, count);
+  px.effectFrameMs = nowMs;
+  px.effectChanged = false;
+  px.dirty = true;
+}
+
+// Marks the edited frame; tickSubdevices() flushes all strips at once, so strips sharing
+// the parallel output go out in one transfer.
+static void tickPixels(uint8_t i) {
+  auto& px = pixelState(i);
+  if (runtimeConfig(i).pixels.mode == PIXEL_MODE_EFFECT && !px.testOn) renderEffectFrame(i);
+  if (!px.dirty) return;
+  px.dirty = false;
+  pixelOutputShow(px.output);
+}
+
+// Blanks the strip; the next frame redraws it in full even if its slots did not change.
+static void blankPixels(uint8_t i) {
+  auto& px = pixelState(i);
+  px.r = 0;
+  px.g = 0;
+  px.b = 0;
+  px.effect = PixelEffectParams();
+  memset(px.effectSlots, 0, sizeof(px.effectSlots));
+  px.effectChanged = false;
+  fillPixels(i, 0, 0, 0);
+  awaitingFrame[i] = AWAITING_ALL_SEGMENTS;
+}
+#endif
+
+static void stopDcOutput(uint8_t i) {
+  setDcTarget(i, true, 0);
+  setDcOutput(i, true, 0);
+}
+
+// Per-type runtime handlers. The decode, tick and loss passes are instantiated once per
+// type and walk only that type's dense list, calling the handler directly instead of
+// switching on each subdevice's type. A type compiled out has ENABLED false and empty
+// handlers, so its passes compile to nothing.
+template <SubdeviceType T> struct SubdeviceRuntime;
+
+template <> struct SubdeviceRuntime<SUBDEVICE_STEPPER> {
+  static constexpr bool ENABLED = true;
+  static void decode(const SubdeviceDispatchEntry& entry, const uint8_t* slots) { decodeStepperSlots(entry.index, slots); }
+  static void tick(uint8_t i) { tickStepper(i); }
+  static void stopOnLoss(uint8_t i) { holdStepperStateOnLoss(i); }
+};
+
+template <> struct SubdeviceRuntime<SUBDEVICE_DC_MOTOR> {
+  static constexpr bool ENABLED = true;
+  static void decode(const SubdeviceDispatchEntry& entry, const uint8_t* slots) { decodeDcSlots(entry.index, slots); }
+  static void tick(uint8_t i) { tickDc(i); }
+  static void stopOnLoss(uint8_t i) { stopDcOutput(i); }
+};
+
+template <> struct SubdeviceRuntime<SUBDEVICE_RELAY> {
+  static constexpr bool ENABLED = true;
+  static void decode(const SubdeviceDispatchEntry& entry, const uint8_t* slots) { decodeDigitalSlots(entry.index, slots); }
+  static void tick(uint8_t) {}
+  static void stopOnLoss(uint8_t i) { setDigitalOutput(i, false); }
+};
+
+template <> struct SubdeviceRuntime<SUBDEVICE_LED> : SubdeviceRuntime<SUBDEVICE_RELAY> {};
+
+#if USE_PIXELS
+template <> struct SubdeviceRuntime<SUBDEVICE_PIXELS> {
+  static constexpr bool ENABLED = true;
+  static void decode(const SubdeviceDispatchEntry& entry, const uint8_t* slots) { decodePixelSlots(entry, slots); }
+  static void tick(uint8_t i) { tickPixels(i); }
+  static void stopOnLoss(uint8_t i) { blankPixels(i); }
+};
+#else
+template <> struct SubdeviceRuntime<SUBDEVICE_PIXELS> {
+  static constexpr bool ENABLED = false;
+  static void decode(const SubdeviceDispatchEntry&, const uint8_t*) {}
+  static void tick(uint8_t) {}
+  static void stopOnLoss(uint8_t) {}
+};
+#endif
+
+static bool subdeviceTypeEnabled(SubdeviceType type) {
+  switch (type) {
+    case SUBDEVICE_STEPPER: return SubdeviceRuntime<SUBDEVICE_STEPPER>::ENABLED;
+    case SUBDEVICE_DC_MOTOR: return SubdeviceRuntime<SUBDEVICE_DC_MOTOR>::ENABLED;
+    case SUBDEVICE_RELAY: return SubdeviceRuntime<SUBDEVICE_RELAY>::ENABLED;
+    case SUBDEVICE_LED: return SubdeviceRuntime<SUBDEVICE_LED>::ENABLED;
+    case SUBDEVICE_PIXELS: return SubdeviceRuntime<SUBDEVICE_PIXELS>::ENABLED;
+    default: return false;
+  }
+}
+
+template <SubdeviceType T>
+static void tickType(const SubdeviceSnapshot& snapshot) {
+  if (!SubdeviceRuntime<T>::ENABLED) return;
+  const auto& list = snapshot.activeByType[T];
+  for (uint8_t k = 0; k < list.count; k++) SubdeviceRuntime<T>::tick(list.index[k]);
+}
+
+template <SubdeviceType T>
+static void stopTypeOnLoss(const SubdeviceSnapshot& snapshot) {
+  if (!SubdeviceRuntime<T>::ENABLED) return;
+  const auto& list = snapshot.activeByType[T];
+  for (uint8_t k = 0; k < list.count; k++) SubdeviceRuntime<T>::stopOnLoss(list.index[k]);
+}
+
+// Word at a time: a mapped pixel segment covers up to 510 slots.
+static bool slotRangeChanged(const uint32_t* changedSlots, uint16_t offset, uint16_t width) {
+  const uint16_t end = (uint16_t)(offset + width);
+  for (uint16_t slot = offset; slot < end; slot = (uint16_t)((slot | 31) + 1)) {
+    uint32_t bits = changedSlots[slot >> 5] >> (slot & 31);
+    if (end - slot < 32) bits &= (1UL << (end - slot)) - 1;
+    if (bits) return true;
+  }
+  return false;
+}
+
+template <SubdeviceType T>
+static void decodeType(const SubdeviceSnapshot& snapshot, const UniverseDispatchList& list, const uint8_t* dmxSlots,
+                       uint16_t slotCount, const uint32_t* changedSlots) {
+  if (!SubdeviceRuntime<T>::ENABLED) return;
+  for (uint8_t e = list.typeFirst[T]; e < list.typeFirst[T + 1]; e++) {
+    const auto& entry = snapshot.dispatchEntries[e];
+    if ((uint16_t)(entry.offset + entry.width) > slotCount) continue;
+    const uint8_t segmentBit = (uint8_t)(1u << entry.segment);
+    if (changedSlots && !(awaitingFrame[entry.index] & segmentBit) && !slotRangeChanged(changedSlots, entry.offset, entry.width)) continue;
+    awaitingFrame[entry.index] &= (uint8_t)~segmentBit;
+    SubdeviceRuntime<T>::decode(entry, dmxSlots + entry.offset);
   }
 }
 
 void tickSubdevices() {
-  for (uint8_t i = 0; i < cfg.subdeviceCount && i < MAX_SUBDEVICES; i++) {
-    if (!cfg.subdevices[i].enabled) continue;
-    if (cfg.subdevices[i].type == SUBDEVICE_STEPPER) tickStepper(i);
-    if (cfg.subdevices[i].type == SUBDEVICE_DC_MOTOR) tickDc(i);
+  serviceRuntimeRequests();
+  if (!activeSnapshot) return;
+
+  tickType<SUBDEVICE_STEPPER>(*activeSnapshot);
+  tickType<SUBDEVICE_DC_MOTOR>(*activeSnapshot);
+  tickType<SUBDEVICE_RELAY>(*activeSnapshot);
+  tickType<SUBDEVICE_LED>(*activeSnapshot);
+  tickType<SUBDEVICE_PIXELS>(*activeSnapshot);
+#if USE_PIXELS
+  pixelFramesWaiting = pixelOutputFlush();
+#endif
+  commitDigitalOutputs();
+}
+
+static bool dcRampPending(uint8_t i) {
+  const auto& state = dcOutputState(i);
+  int32_t targetSignedDuty = state.targetForward ? (int32_t)state.targetDuty : -(int32_t)state.targetDuty;
+  return !state.initialized || state.filteredSignedDuty != targetSignedDuty;
+}
+
+void subdevicesNextDeadline(RuntimeDeadline& deadline) {
+  if (pendingSnapshot.load(std::memory_order_acquire) || pendingRuntimeRequest.load(std::memory_order_acquire)) {
+    deadlineIn(deadline, 0);
+    return;
   }
+  if (!activeSnapshot) return;
+
+  const auto& steppers = activeSnapshot->activeByType[SUBDEVICE_STEPPER];
+  for (uint8_t k = 0; k < steppers.count; k++) {
+    const auto& st = stepperState(steppers.index[k]);
+    if (st.homeLatched) {
+      deadlineIn(deadline, st.homeHandled ? STEPPER_SWITCH_HELD_POLL_MS : 0);
+    } else if (st.homeSwitchPolled) {
+      deadlineIn(deadline, STEPPER_SWITCH_POLL_MS);
+    }
+  }
+  // A ramping DC output moves on every elapsed millisecond.
+  const auto& dcs = activeSnapshot->activeByType[SUBDEVICE_DC_MOTOR];
+  for (uint8_t k = 0; k < dcs.count; k++) {
+    if (dcRampPending(dcs.index[k])) deadlineIn(deadline, 1);
+  }
+#if USE_PIXELS
+  // An edited frame is shown at once; one held back by the wire is retried every millisecond.
+  // A running effect is due at its next frame.
+  if (pixelFramesWaiting) deadlineIn(deadline, 1);
+  const auto& strips = activeSnapshot->activeByType[SUBDEVICE_PIXELS];
+  for (uint8_t k = 0; k < strips.count; k++) {
+    const uint8_t i = strips.index[k];
+    const auto& px = pixelState(i);
+    const bool effect = runtimeConfig(i).pixels.mode == PIXEL_MODE_EFFECT && !px.testOn;
+    if (px.dirty || (effect && px.effectChanged)) {
+      deadlineIn(deadline, 0);
+    } else if (effect && pixelEffectAnimated(px.effect)) {
+      deadlineAt(deadline, px.effectFrameMs + PIXEL_EFFECT_FRAME_MS);
+    }
+  }
+#endif
 }
 
-void applySacnToSubdevices(uint16_t universe, const uint8_t* dmxSlots, uint16_t slotCount) {
-  for (uint8_t i = 0; i < cfg.subdeviceCount && i < MAX_SUBDEVICES; i++) {
-    auto& sd = cfg.subdevices[i];
-    if (!sd.enabled || sd.map.universe != universe) continue;
-
-    uint8_t width = subdeviceSlotWidth(sd);
-    if (sd.map.startAddr < 1) continue;
-    if ((uint16_t)(sd.map.startAddr + width - 1) > slotCount) continue;
-
-    switch (sd.type) {
-      case SUBDEVICE_DC_MOTOR: {
-        uint16_t raw = sd.dc.command16Bit
-                       ? readU16(dmxSlots, sd.map.startAddr)
-                       : (uint16_t)(dmxSlots[sd.map.startAddr - 1] * 257U);
-        int16_t signedCmd = (int16_t)((int32_t)raw - 32768);
-        int32_t v = signedCmd;
-        if (abs(v) <= sd.dc.deadband || raw == 0) v = 0;
-        if (v == 0) { setDcTarget(i, true, 0); break; }
-        bool fwd = (v > 0);
-        uint32_t mag = (uint32_t)abs(v);
-        uint32_t out = (mag * sd.dc.maxPwm) / 32768;
-        if (out < 1) out = 1;
-        if (out > sd.dc.maxPwm) out = sd.dc.maxPwm;
-        setDcTarget(i, fwd, (uint16_t)out);
-        break;
-      }
-      case SUBDEVICE_STEPPER: {
-        auto& st = stepperStates[i];
-        uint8_t controlRaw = 0;
-        int32_t targetWithinRev = 0;
-
-        if (sd.stepper.position16Bit) {
-          uint16_t positionRaw16 = readU16(dmxSlots, sd.map.startAddr);
-          controlRaw = dmxSlots[sd.map.startAddr + 1];
-          targetWithinRev = mapPositionToSteps(positionRaw16, 65535, sd.stepper.stepsPerRev);
-        } else {
-          uint8_t positionRaw8 = dmxSlots[sd.map.startAddr - 1];
-          controlRaw = dmxSlots[sd.map.startAddr];
-          targetWithinRev = mapPositionToSteps(positionRaw8, 255, sd.stepper.stepsPerRev);
-        }
-
-        bool safetyEnabled = (controlRaw & 0x01) != 0;
-        uint8_t speedRaw = controlRaw & 0xFE;
-
-        if (!safetyEnabled) {
-          st.safetyEnabled = false;
-          storeStepperControlCommand(i, targetWithinRev, speedRaw);
-          disableStepperForSafety(i);
-          break;
-        }
-
-        bool wasSafetyDisabled = !st.safetyEnabled;
-        st.safetyEnabled = true;
-        if (wasSafetyDisabled && st.hasStoredCommand) {
-          if (st.storedVelocityMode) {
-            applyStepperVelocityCommand(i, st.storedSpeedRaw);
-          } else {
-            applyStepperAbsoluteCommand(i, st.storedTargetWithinRev);
-          }
-          st.hasStoredCommand = false;
-          break;
-        }
-
-        applyStepperControlCommand(i, targetWithinRev, speedRaw);
-        break;
-      }
-      case SUBDEVICE_RELAY: {
-        bool on = dmxSlots[sd.map.startAddr - 1] >= 128;
-        setRelayOutput(i, on);
-        break;
+// Rebuilds the per-type active lists and the universe -> subdevice dispatch index.
+// Entries are grouped by universe, then by type, so a frame apply walks one dense run per
+// type of only the subdevices bound to that universe.
+static bool dispatchable(const SubdeviceConfig& sd) {
+  return sd.enabled && sd.type < SUBDEVICE_TYPE_COUNT && subdeviceTypeEnabled(sd.type);
+}
+
+static void rebuildSubdeviceDispatch(SubdeviceSnapshot& snapshot) {
+  auto* dispatchEntries = snapshot.dispatchEntries;
+  auto* dispatchUniverses = snapshot.dispatchUniverses;
+  uint8_t& dispatchEntryCount = snapshot.dispatchEntryCount;
+  uint8_t& dispatchUniverseCount = snapshot.dispatchUniverseCount;
+  dispatchEntryCount = 0;
+  dispatchUniverseCount = 0;
+  snapshot.droppedSegments = 0;
+  for (auto& list : snapshot.activeByType) list.count = 0;
+
+  // Count entries per universe and type in typeFirst[type + 1].
+  DispatchSegment segments[MAX_PIXEL_SEGMENTS];
+  for (uint8_t i = 0; i < snapshot.subdeviceCount; i++) {
+    auto& sd = snapshot.subdevices[i];
+    if (!dispatchable(sd) || snapshot.runtimeSlot[i] == RUNTIME_SLOT_NONE) continue;
+    auto& active = snapshot.activeByType[sd.type];
+    active.index[active.count++] = i;
+
+    uint8_t segmentCount = subdeviceSegments(sd, segments);
+    for (uint8_t s = 0; s < segmentCount; s++) {
+      uint8_t u = 0;
+      while (u < dispatchUniverseCount && dispatchUniverses[u].universe != segments[s].universe) u++;
+      // Universes past MAX_UNIVERSES are not received, so their segments get no entry.
+      if (u == MAX_UNIVERSES) {
+        snapshot.droppedSegments++;
+        continue;
       }
-      case SUBDEVICE_LED: {
-        bool on = dmxSlots[sd.map.startAddr - 1] >= 128;
-        setLedOutput(i, on);
-        break;
+      if (u == dispatchUniverseCount) {
+        dispatchUniverses[u].universe = segments[s].universe;
+        memset(dispatchUniverses[u].typeFirst, 0, sizeof(dispatchUniverses[u].typeFirst));
+        dispatchUniverseCount++;
       }
-      case SUBDEVICE_PIXELS: {
-#if USE_PIXELS
-        if (!pixelStrips[i]) break;
-        uint8_t r = dmxSlots[sd.map.startAddr - 1];
-        uint8_t g = dmxSlots[sd.map.startAddr];
-        uint8_t b = dmxSlots[sd.map.startAddr + 1];
-        if (pixelCommands[i].r == r && pixelCommands[i].g == g && pixelCommands[i].b == b) break;
-        pixelCommands[i].r = r;
-        pixelCommands[i].g = g;
-        pixelCommands[i].b = b;
-        for (uint16_t p = 0; p < sd.pixels.count; p++) {
-          pixelStrips[i]->setPixelColor(p, pixelStrips[i]->Color(r, g, b));
-        }
-        pixelStrips[i]->show();
-#endif
-        break;
+      dispatchUniverses[u].typeFirst[sd.type + 1]++;
+    }
+  }
+
+  uint8_t offset = 0;
+  for (uint8_t u = 0; u < dispatchUniverseCount; u++) {
+    auto& list = dispatchUniverses[u];
+    list.typeFirst[0] = offset;
+    for (uint8_t t = 0; t < SUBDEVICE_TYPE_COUNT; t++) list.typeFirst[t + 1] = (uint8_t)(list.typeFirst[t] + list.typeFirst[t + 1]);
+    offset = list.typeFirst[SUBDEVICE_TYPE_COUNT];
+  }
+
+  // Fill type by type; each universe's cursor walks its run for that type.
+  uint8_t cursor[MAX_UNIVERSES];
+  for (uint8_t t = 0; t < SUBDEVICE_TYPE_COUNT; t++) {
+    for (uint8_t u = 0; u < dispatchUniverseCount; u++) cursor[u] = dispatchUniverses[u].typeFirst[t];
+    const auto& active = snapshot.activeByType[t];
+    for (uint8_t k = 0; k < active.count; k++) {
+      uint8_t i = active.index[k];
+      uint8_t segmentCount = subdeviceSegments(snapshot.subdevices[i], segments);
+      for (uint8_t s = 0; s < segmentCount; s++) {
+        uint8_t u = 0;
+        while (u < dispatchUniverseCount && dispatchUniverses[u].universe != segments[s].universe) u++;
+        if (u == dispatchUniverseCount) continue;
+        auto& entry = dispatchEntries[cursor[u]++];
+        entry.index = i;
+        entry.segment = s;
+        entry.offset = segments[s].offset;
+        entry.width = segments[s].width;
+        entry.firstPixel = segments[s].firstPixel;
+        dispatchEntryCount++;
       }
-      default:
-        break;
     }
   }
 }
 
-void stopSubdevicesOnLoss() {
-  for (uint8_t i = 0; i < cfg.subdeviceCount && i < MAX_SUBDEVICES; i++) {
-    auto& sd = cfg.subdevices[i];
-    if (!sd.enabled) continue;
-    switch (sd.type) {
-      case SUBDEVICE_DC_MOTOR:
-        setDcTarget(i, true, 0);
-        setDcOutput(i, true, 0);
-        break;
-      case SUBDEVICE_RELAY:
-        setRelayOutput(i, false);
-        break;
-      case SUBDEVICE_LED:
-        setLedOutput(i, false);
-        break;
-      case SUBDEVICE_PIXELS:
-#if USE_PIXELS
-        if (pixelStrips[i]) {
-          pixelStrips[i]->clear();
-          pixelStrips[i]->show();
-        }
-#endif
-        break;
-      case SUBDEVICE_STEPPER:
-        holdStepperStateOnLoss(i);
-        break;
-      default:
-        break;
-    }
+void applySacnToSubdevices(uint16_t universe, const uint8_t* dmxSlots, uint16_t slotCount, const uint32_t* changedSlots) {
+  // A config edit re-offers the buffered frames; adopt first so they reach its new devices.
+  adoptPendingSnapshot();
+  const SubdeviceSnapshot* snapshot = activeSnapshot;
+  if (!snapshot) return;
+  for (uint8_t u = 0; u < snapshot->dispatchUniverseCount; u++) {
+    const auto& list = snapshot->dispatchUniverses[u];
+    if (list.universe != universe) continue;
+
+    decodeType<SUBDEVICE_STEPPER>(*snapshot, list, dmxSlots, slotCount, changedSlots);
+    decodeType<SUBDEVICE_DC_MOTOR>(*snapshot, list, dmxSlots, slotCount, changedSlots);
+    decodeType<SUBDEVICE_RELAY>(*snapshot, list, dmxSlots, slotCount, changedSlots);
+    decodeType<SUBDEVICE_LED>(*snapshot, list, dmxSlots, slotCount, changedSlots);
+    decodeType<SUBDEVICE_PIXELS>(*snapshot, list, dmxSlots, slotCount, changedSlots);
+    commitDigitalOutputs();
+    return;
   }
 }
 
-bool runSubdeviceTest(uint8_t index) {
-  if (index >= cfg.subdeviceCount) return false;
-  auto& sd = cfg.subdevices[index];
+void stopSubdevicesOnLoss() {
+  if (!activeSnapshot) return;
+  stopTypeOnLoss<SUBDEVICE_STEPPER>(*activeSnapshot);
+  stopTypeOnLoss<SUBDEVICE_DC_MOTOR>(*activeSnapshot);
+  stopTypeOnLoss<SUBDEVICE_RELAY>(*activeSnapshot);
+  stopTypeOnLoss<SUBDEVICE_LED>(*activeSnapshot);
+  stopTypeOnLoss<SUBDEVICE_PIXELS>(*activeSnapshot);
+  commitDigitalOutputs();
+}
+
+static bool runSubdeviceTestNow(uint8_t index) {
+  if (index >= activeSnapshot->subdeviceCount) return false;
+  auto& sd = runtimeConfig(index);
 
   switch (sd.type) {
     case SUBDEVICE_STEPPER: {
-      int32_t delta = (int32_t)(sd.stepper.stepsPerRev / 4);
-      stepperStates[index].velocityMode = false;
-      stepperStates[index].target = stepperStates[index].current + delta;
+      if (!stepperProfile(index)) return false;
+      int32_t delta = (int32_t)(stepperProfile(index)->stepsPerRev / 4);
+      stepTimerLock();
+      stepperState(index).velocityMode = false;
+      stepperState(index).target = stepperState(index).current + delta;
+      markStepperCommandReady(index);
+      stepTimerUnlock();
       return true;
     }
     case SUBDEVICE_DC_MOTOR: {
-      dcTestStates[index] = !dcTestStates[index];
-      if (!dcTestStates[index]) {
-        setDcTarget(index, true, 0);
-        setDcOutput(index, true, 0);
+      auto& state = dcOutputState(index);
+      state.testOn = !state.testOn;
+      if (!state.testOn) {
+        stopDcOutput(index);
       } else {
         setDcTarget(index, true, (uint16_t)(sd.dc.maxPwm / 2));
         setDcOutput(index, true, (uint16_t)(sd.dc.maxPwm / 2));
@@ -723,37 +1702,55 @@ bool runSubdeviceTest(uint8_t index) {
       return true;
     }
     case SUBDEVICE_RELAY:
-      setRelayOutput(index, !relayStates[index]);
-      return true;
     case SUBDEVICE_LED:
-      setLedOutput(index, !ledStates[index]);
+      setDigitalOutput(index, !digitalOutput(index).on);
       return true;
-    case SUBDEVICE_PIXELS:
+    case SUBDEVICE_PIXELS: {
 #if USE_PIXELS
-      if (!pixelStrips[index]) return false;
-      pixelTestStates[index] = !pixelTestStates[index];
-      for (uint16_t p = 0; p < sd.pixels.count; p++) {
-        if (pixelTestStates[index]) {
-          pixelStrips[index]->setPixelColor(p, pixelStrips[index]->Color(255, 255, 255));
-        } else {
-          pixelStrips[index]->setPixelColor(p, pixelStrips[index]->Color(0, 0, 0));
-        }
-      }
-      pixelStrips[index]->show();
+      auto& px = pixelState(index);
+      if (px.output == PIXEL_OUTPUT_NONE) return false;
+      px.testOn = !px.testOn;
+      const uint8_t level = px.testOn ? 255 : 0;
+      fillPixels(index, level, level, level);
+      // An effect holds the test fill and picks up again once it is off.
+      px.effectChanged = !px.testOn;
       return true;
 #else
       return false;
 #endif
+    }
     default:
       return false;
   }
 }
 
+static void runRuntimeRequest(uint8_t kind, uint8_t index) {
+  if (!activeSnapshot || index >= activeSnapshot->subdeviceCount || runtimeSlots[index] == RUNTIME_SLOT_NONE) return;
+  if (kind == RUNTIME_REQUEST_TEST) {
+    runSubdeviceTestNow(index);
+  } else if (kind == RUNTIME_REQUEST_HOME && runtimeConfig(index).type == SUBDEVICE_STEPPER) {
+    homeStepperState(index);
+  }
+}
+
+// Web-side entry points validate against the edited config and hand the action to the
+// runtime, which owns the output state.
+bool runSubdeviceTest(uint8_t index) {
+  if (index >= cfg.subdeviceCount) return false;
+#if !USE_PIXELS
+  if (cfg.subdevices[index].type == SUBDEVICE_PIXELS) return false;
+#endif
+  if (cfg.subdevices[index].type > SUBDEVICE_PIXELS) return false;
+  pendingRuntimeRequest.store((uint16_t)((RUNTIME_REQUEST_TEST << 8) | index), std::memory_order_release);
+  runtimeWakeNotify();
+  return true;
+}
+
 bool homeStepperSubdevice(uint8_t index) {
   if (index >= cfg.subdeviceCount) return false;
-  auto& sd = cfg.subdevices[index];
-  if (sd.type != SUBDEVICE_STEPPER) return false;
-  homeStepperState(index);
+  if (cfg.subdevices[index].type != SUBDEVICE_STEPPER) return false;
+  pendingRuntimeRequest.store((uint16_t)((RUNTIME_REQUEST_HOME << 8) | index), std::memory_order_release);
+  runtimeWakeNotify();
   return true;
 }
 
@@ -771,20 +1768,52 @@ uint16_t subdeviceMinUniverse() {
 uint16_t subdeviceMaxUniverse() {
   uint16_t maxU = 1;
   bool found = false;
+  DispatchSegment segments[MAX_PIXEL_SEGMENTS];
   for (uint8_t i = 0; i < cfg.subdeviceCount && i < MAX_SUBDEVICES; i++) {
     if (!cfg.subdevices[i].enabled) continue;
-    if (!found || cfg.subdevices[i].map.universe > maxU) maxU = cfg.subdevices[i].map.universe;
+    uint8_t segmentCount = subdeviceSegments(cfg.subdevices[i], segments);
+    uint16_t last = segmentCount ? segments[segmentCount - 1].universe : cfg.subdevices[i].map.universe;
+    if (!found || last > maxU) maxU = last;
     found = true;
   }
   return found ? maxU : cfg.universe;
 }
 
+uint8_t subdeviceUniversesNeeded() {
+  uint16_t seen[MAX_UNIVERSES + 1];
+  uint8_t count = 0;
+  DispatchSegment segments[MAX_PIXEL_SEGMENTS];
+  for (uint8_t i = 0; i < cfg.subdeviceCount && i < MAX_SUBDEVICES; i++) {
+    if (!dispatchable(cfg.subdevices[i])) continue;
+    uint8_t segmentCount = subdeviceSegments(cfg.subdevices[i], segments);
+    for (uint8_t s = 0; s < segmentCount; s++) {
+      uint8_t u = 0;
+      while (u < count && seen[u] != segments[s].universe) u++;
+      if (u < count) continue;
+      if (count > MAX_UNIVERSES) return count;
+      seen[count++] = segments[s].universe;
+    }
+  }
+  return count;
+}
+
+// Distinct universes with at least one enabled subdevice in the newest published
+// snapshot, in dispatch-index order. Publisher side only.
+uint8_t subdeviceUniverseCount() {
+  return publishedSnapshot ? publishedSnapshot->dispatchUniverseCount : 0;
+}
+
+uint16_t subdeviceUniverseAt(uint8_t index) {
+  if (index >= subdeviceUniverseCount()) return 0;
+  return publishedSnapshot->dispatchUniverses[index].universe;
+}
+
 bool addSubdevice(SubdeviceType type, const String& name) {
   if (cfg.subdeviceCount >= MAX_SUBDEVICES) return false;
   uint8_t idx = cfg.subdeviceCount++;
   SubdeviceConfig& sd = cfg.subdevices[idx];
   sd = SubdeviceConfig();
-  sd.type = type;
+  setSubdeviceType(sd, type);
   sd.enabled = true;
   sd.map.universe = cfg.universe;
   sd.map.startAddr = 1;
@@ -794,27 +1823,50 @@ bool addSubdevice(SubdeviceType type, const String& name) {
   return true;
 }
 
+// Removes the subdevice from `cfg` and publishes a snapshot whose remaining subdevices
+// keep their runtime state, so motion on the others is not interrupted.
 bool deleteSubdevice(uint8_t index) {
   if (index >= cfg.subdeviceCount) return false;
-#if USE_PIXELS
-  if (pixelStrips[index]) {
-    delete pixelStrips[index];
-    pixelStrips[index] = nullptr;
+  uint8_t runtimeSource[MAX_SUBDEVICES];
+  for (uint8_t i = 0; i < MAX_SUBDEVICES; i++) runtimeSource[i] = SNAPSHOT_NEW_RUNTIME;
+  for (uint8_t i = 0; i + 1 < cfg.subdeviceCount; i++) {
+    uint8_t source = i < index ? i : (uint8_t)(i + 1);
+    if (publishedSnapshot && source < publishedSnapshot->subdeviceCount) runtimeSource[i] = source;
   }
-#endif
   for (uint8_t i = index; i + 1 < cfg.subdeviceCount; i++) {
     cfg.subdevices[i] = cfg.subdevices[i + 1];
-    stepperStates[i] = stepperStates[i + 1];
-    dcOutputStates[i] = dcOutputStates[i + 1];
-    relayStates[i] = relayStates[i + 1];
-    ledStates[i] = ledStates[i + 1];
-    dcTestStates[i] = dcTestStates[i + 1];
-#if USE_PIXELS
-    pixelStrips[i] = pixelStrips[i + 1];
-    pixelStrips[i + 1] = nullptr;
-    pixelTestStates[i] = pixelTestStates[i + 1];
-#endif
   }
   cfg.subdeviceCount--;
+  publishSubdeviceSnapshot(runtimeSource);
   return true;
 }
+
+static String featureFlag(const char* name, bool on) {
+  return String(" ") + name + "=" + (on ? "1" : "0");
+}
+
+String subdeviceMemoryReport() {
+  String s;
+  s += "config " + String((uint32_t)sizeof(SubdeviceConfig)) + " B x " + String(MAX_SUBDEVICES);
+  s += ", snapshot " + String((uint32_t)sizeof(SubdeviceSnapshot)) + " B";
+  s += ", arena " + String((uint32_t)sizeof(RuntimeArena)) + " B (stepper " + String(STEPPER_POOL_SIZE) + " x " + String((uint32_t)sizeof(StepperState));
+  s += ", dc " + String(DC_POOL_SIZE) + " x " + String((uint32_t)sizeof(DcOutputState));
+  s += ", digital " + String(DIGITAL_POOL_SIZE) + " x " + String((uint32_t)sizeof(DigitalOutputState));
+#if USE_PIXELS
+  s += ", pixels " + String(PIXEL_POOL_SIZE) + " x " + String((uint32_t)sizeof(PixelState));
+#endif
+  s += "), stepper tables " + String((uint32_t)(sizeof(StepperMotionProfile) + sizeof(StepperRamp))) + " B each;";
+#if USE_PIXELS
+  PixelOutputMemory px;
+  pixelOutputMemory(px);
+  s += " pixel frames " + String(px.framesUsed) + "/" + String(px.arenaBytes) + " B (peak " + String(px.framesPeak);
+  s += ", largest free " + String(px.arenaLargestFree) + ", refused " + String(px.refused) + ")";
+  s += ", DMA " + String(px.dmaBytes) + " B for " + String(px.dmaPixels) + " px (peak " + String(px.dmaPeakPixels) + ")";
+  s += ", heap " + String(px.heapFree) + " B free, largest " + String(px.heapLargest) + " (~" + String(px.headroomPixels) + " px more);";
+#endif
+  uint8_t dropped = publishedSnapshot ? publishedSnapshot->droppedSegments : 0;
+  s += " universes " + String(subdeviceUniverseCount()) + "/" + String(MAX_UNIVERSES) + " (dropped segments " + String(dropped) + ");";
+  s += featureFlag("USE_WEB_UI", USE_WEB_UI) + featureFlag("USE_SACN", USE_SACN) + featureFlag("USE_ARTNET", USE_ARTNET);
+  s += featureFlag("USE_OTA", USE_OTA) + featureFlag("USE_PIXELS", USE_PIXELS) + featureFlag("USE_ESP32_DUAL_CORE", USE_ESP32_DUAL_CORE);
+  return s;
+}
@@ -7,6 +7,7 @@
 #include "platform/compat/http_server.h"
 
 #include "core/config.h"
+#include "core/pixel_effects.h"
 #include "core/subdevices.h"
 #include "platform/platform_services.h"
 #include "platform/config_storage.h"
@@ -47,6 +48,7 @@ struct DriverDescriptor {
 
 static constexpr DriverDescriptor STEPPER_DRIVER_DESCRIPTORS[] = {
   {STEPPER_DRIVER_GENERIC, "Generic"},
+  {STEPPER_DRIVER_STEP_DIR, "STEP/DIR (A4988/TMC)"},
 };
 
 static constexpr DriverDescriptor DC_DRIVER_DESCRIPTORS[] = {
@@ -57,6 +59,15 @@ static constexpr DriverDescriptor PIXEL_DRIVER_DESCRIPTORS[] = {
   {PIXEL_DRIVER_GENERIC, "Generic"},
 };
 
+static constexpr DriverDescriptor PIXEL_COLOR_ORDER_DESCRIPTORS[] = {
+  {PIXEL_ORDER_GRB, "GRB (WS2812B)"},
+  {PIXEL_ORDER_RGB, "RGB"},
+  {PIXEL_ORDER_BRG, "BRG"},
+  {PIXEL_ORDER_RBG, "RBG"},
+  {PIXEL_ORDER_GBR, "GBR"},
+  {PIXEL_ORDER_BGR, "BGR"},
+};
+
 static String driverOptions(const DriverDescriptor* descriptors, size_t count, uint8_t selected) {
   String s;
   for (size_t i = 0; i < count; i++) {
@@ -74,6 +85,14 @@ static String stepperSeekModeOptions(StepperSeekMode selected) {
   return s;
 }
 
+static String pixelModeOptions(PixelMode selected) {
+  String s;
+  s += "<option value='" + String(PIXEL_MODE_SOLID) + "'" + String(selected == PIXEL_MODE_SOLID ? " selected" : "") + ">Solid (3 slots)</option>";
+  s += "<option value='" + String(PIXEL_MODE_MAPPED) + "'" + String(selected == PIXEL_MODE_MAPPED ? " selected" : "") + ">Mapped (3 slots per pixel)</option>";
+  s += "<option value='" + String(PIXEL_MODE_EFFECT) + "'" + String(selected == PIXEL_MODE_EFFECT ? " selected" : "") + ">Effect (" + String(PIXEL_EFFECT_SLOTS) + " slots)</option>";
+  return s;
+}
+
 static String stepperDirectionOptions(StepperDirection selected) {
   String s;
   s += "<option value='" + String(STEPPER_DIR_CW) + "'" + String(selected == STEPPER_DIR_CW ? " selected" : "") + ">CW</option>";
@@ -96,9 +115,17 @@ static void renderTypeSpecificFields(String& s, const SubdeviceConfig& sd) {
            "IN1 <input name='st1' type='number' value='" + String(sd.stepper.in1) + "'> "
            "IN2 <input name='st2' type='number' value='" + String(sd.stepper.in2) + "'> "
            "IN3 <input name='st3' type='number' value='" + String(sd.stepper.in3) + "'> "
-           "IN4 <input name='st4' type='number' value='" + String(sd.stepper.in4) + "'><br><br>"
+           "IN4 <input name='st4' type='number' value='" + String(sd.stepper.in4) + "'><br>"
+           "STEP <input name='ststep' type='number' value='" + String(sd.stepper.stepPin) + "'> "
+           "DIR <input name='stdirpin' type='number' value='" + String(sd.stepper.dirPin) + "'> "
+           "EN <input name='sten' type='number' value='" + String(sd.stepper.enablePin) + "'> "
+           "Microsteps <input name='stmicro' type='number' min='1' max='256' value='" + String(sd.stepper.microsteps) + "'><br>"
+           "<small>Generic uses IN1-IN4 (4-wire half-step). STEP/DIR uses STEP, DIR and optional EN (active low, 255 = none).</small><br><br>"
            "Steps/rev <input name='stspr' type='number' value='" + String(sd.stepper.stepsPerRev) + "'> "
            "Max deg/sec <input name='stspd' type='number' step='0.1' value='" + String(sd.stepper.maxDegPerSec) + "'><br>"
+           "Accel deg/s&sup2; <input name='stacc' type='number' step='0.1' value='" + String(sd.stepper.accelDegPerSec2) + "'> "
+           "Jerk deg/s&sup3; <input name='stjerk' type='number' step='0.1' value='" + String(sd.stepper.jerkDegPerSec3) + "'><br>"
+           "<small>Accel 0 = no ramp. Jerk 0 = trapezoidal ramp, non-zero = S-curve.</small><br>"
            "<label><input type='checkbox' name='st16' " + String(sd.stepper.position16Bit ? "checked" : "") + ">16-bit position (CH1+CH2)</label><br>"
            "Seek mode <select name='stseekmode'>" + stepperSeekModeOptions(sd.stepper.seekMode) + "</select> "
            "Forward direction <select name='stfwddir'>" + stepperDirectionOptions(sd.stepper.seekForwardDirection) + "</select> "
@@ -134,9 +161,12 @@ static void renderTypeSpecificFields(String& s, const SubdeviceConfig& sd) {
            "LED active high <input type='checkbox' name='ledah' " + String(sd.led.activeHigh ? "checked" : "") + "></fieldset><br>";
       break;
     case SUBDEVICE_PIXELS:
-      s += "<fieldset><legend>Pixel Strip</legend>Driver <select name='pxdrv'>" + driverOptions(PIXEL_DRIVER_DESCRIPTORS, sizeof(PIXEL_DRIVER_DESCRIPTORS) / sizeof(PIXEL_DRIVER_DESCRIPTORS[0]), sd.pixels.driver) + "</select><br><br>Pixel pin <input name='pxpin' type='number' value='" + String(sd.pixels.pin) + "'> "
+      s += "<fieldset><legend>Pixel Strip</legend>Driver <select name='pxdrv'>" + driverOptions(PIXEL_DRIVER_DESCRIPTORS, sizeof(PIXEL_DRIVER_DESCRIPTORS) / sizeof(PIXEL_DRIVER_DESCRIPTORS[0]), sd.pixels.driver) + "</select> "
+           "Mode <select name='pxmode'>" + pixelModeOptions(sd.pixels.mode) + "</select><br><br>Pixel pin <input name='pxpin' type='number' value='" + String(sd.pixels.pin) + "'> "
            "Count <input name='pxcount' type='number' value='" + String(sd.pixels.count) + "'> "
-           "Brightness <input name='pxb' type='number' value='" + String(sd.pixels.brightness) + "'></fieldset><br>";
+           "Brightness <input name='pxb' type='number' value='" + String(sd.pixels.brightness) + "'><br>"
+           "Color order <select name='pxorder'>" + driverOptions(PIXEL_COLOR_ORDER_DESCRIPTORS, sizeof(PIXEL_COLOR_ORDER_DESCRIPTORS) / sizeof(PIXEL_COLOR_ORDER_DESCRIPTORS[0]), sd.pixels.colorOrder) + "</select> "
+           "Gamma <input name='pxgamma' type='number' step='0.1' value='" + String(sd.pixels.gamma) + "'></fieldset><br>";
       break;
     default:
       break;
@@ -158,11 +188,16 @@ static void handleRoot() {
   s += "<h3>Configured Subdevices (" + String(cfg.subdeviceCount) + "/" + String(MAX_SUBDEVICES) + ")</h3><ul>";
   for (uint8_t i = 0; i < cfg.subdeviceCount; i++) {
     auto& sd = cfg.subdevices[i];
-    s += "<li>#" + String(i + 1) + " <b>" + esc(String(sd.name)) + "</b> [" + subdeviceTypeName(sd.type) + "] U" + String(sd.map.universe) + " @ " + String(sd.map.startAddr);
+    s += "<li>#" + String(i + 1) + " <b>" + esc(String(sd.name)) + "</b> [" + subdeviceTypeName(sd.type) + "] U" + String(sd.map.universe);
+    uint8_t span = subdeviceUniverseSpan(sd);
+    if (span > 1) s += "-" + String(sd.map.universe + span - 1);
+    s += " @ " + String(sd.map.startAddr);
     s += sd.enabled ? " (enabled)" : " (disabled)";
     s += "</li>";
   }
-  s += "</ul></body></html>";
+  s += "</ul>";
+  s += "<p><small><b>Subdevice RAM:</b> " + subdeviceMemoryReport() + "</small></p>";
+  s += "</body></html>";
   server.send(200, "text/html", s);
 }
 
@@ -187,6 +222,9 @@ static void handleDmx() {
   s += String("<option value='1'") + (cfg.sacnMode == SACN_MULTICAST ? " selected" : "") + ">Multicast</option>";
   s += "</select><br><br>";
   s += "sACN buffer (ms): <input name='sb' type='number' min='0' max='10000' value='" + String(cfg.sacnBufferMs) + "'><br><br>";
+#if USE_ARTNET
+  s += "Art-Net universe offset: <input name='ao' type='number' min='0' max='63999' value='" + String(cfg.artnetUniverseOffset) + "'> <small>(sACN universe = Art-Net port-address + offset)</small><br><br>";
+#endif
   s += "DMX loss timeout (ms): <input name='to' type='number' min='100' max='60000' value='" + String(cfg.lossTimeoutMs) + "'><br><br>";
   s += "On loss: <select name='lm'>";
   s += String("<option value='0'") + (cfg.lossMode == LOSS_FORCE_OFF ? " selected" : "") + ">Force OFF</option>";
@@ -250,6 +288,11 @@ static void handleSubdevices() {
   s += "Name <input name='name' placeholder='optional'> ";
   s += "Type <select name='type'>" + typeOptions(SUBDEVICE_STEPPER) + "</select> ";
   s += "<button type='submit'>Add Subdevice</button></form>";
+#if USE_PIXELS
+  s += "<form method='POST' action='/subdevices/pixelheadroom' style='padding:8px;'>";
+  s += "Pixel headroom <input name='ph' type='number' min='0' max='" + String(MAX_PIXELS_PER_STRIP) + "' value='" + String(cfg.pixelHeadroom) + "'> ";
+  s += "<button type='submit'>Save</button> <small>(frame memory for strips added or lengthened later; applies after reboot)</small></form>";
+#endif
 
   for (uint8_t i = 0; i < cfg.subdeviceCount; i++) renderSubdeviceForm(s, i);
 
@@ -276,6 +319,9 @@ static void handleSaveDmx() {
   if (server.method() != HTTP_POST) { server.send(405, "text/plain", "Method Not Allowed"); return; }
   cfg.sacnMode = (SacnMode)server.arg("m").toInt();
   cfg.sacnBufferMs = (uint16_t)server.arg("sb").toInt();
+#if USE_ARTNET
+  if (server.hasArg("ao")) cfg.artnetUniverseOffset = (uint16_t)server.arg("ao").toInt();
+#endif
   cfg.lossTimeoutMs = (uint32_t)server.arg("to").toInt();
   cfg.lossMode = (DmxLossMode)server.arg("lm").toInt();
   sanity();
@@ -285,6 +331,21 @@ static void handleSaveDmx() {
   server.send(303);
 }
 
+// Sends a 400 when the edited `cfg` needs more than MAX_UNIVERSES universes (the rest would
+// never be received) or more pixel frame memory than was reserved at boot (those strips would
+// stay dark); the caller then rolls its edit back.
+static bool refuseUnfittingConfig() {
+  if (subdeviceUniversesNeeded() > MAX_UNIVERSES) {
+    server.send(400, "text/plain", "Too many universes (max " + String(MAX_UNIVERSES) + ")");
+    return true;
+  }
+  if (!subdevicePixelsFit()) {
+    server.send(400, "text/plain", "Not enough pixel frame memory reserved at boot (raise the pixel headroom and reboot)");
+    return true;
+  }
+  return false;
+}
+
 static void handleAddSubdevice() {
   if (server.method() != HTTP_POST) { server.send(405, "text/plain", "Method Not Allowed"); return; }
   SubdeviceType type = (SubdeviceType)server.arg("type").toInt();
@@ -292,8 +353,14 @@ static void handleAddSubdevice() {
     server.send(400, "text/plain", "Cannot add subdevice (max reached)");
     return;
   }
+  // The new subdevice sits on cfg.universe, which may be one universe too many, and a new
+  // strip needs frame memory.
+  if (refuseUnfittingConfig()) {
+    cfg.subdeviceCount--;
+    return;
+  }
   saveConfig();
-  initSubdevices();
+  publishSubdeviceChanges();
   restartSacn();
   server.sendHeader("Location", "/subdevices");
   server.send(303);
@@ -304,9 +371,10 @@ static void handleUpdateSubdevice() {
   int idx = server.arg("id").toInt();
   if (idx < 0 || idx >= cfg.subdeviceCount) { server.send(400, "text/plain", "Invalid id"); return; }
   SubdeviceConfig& sd = cfg.subdevices[idx];
+  const SubdeviceConfig previous = sd;
 
   sd.enabled = server.hasArg("en");
-  sd.type = (SubdeviceType)server.arg("type").toInt();
+  SubdeviceType type = (SubdeviceType)server.arg("type").toInt();
   String name = server.arg("name");
   if (name.length() == 0) name = String("subdevice-") + String(idx + 1);
   name.toCharArray(sd.name, sizeof(sd.name));
@@ -314,14 +382,23 @@ static void handleUpdateSubdevice() {
   sd.map.universe = (uint16_t)server.arg("u").toInt();
   sd.map.startAddr = (uint16_t)server.arg("a").toInt();
 
-  if (sd.type == SUBDEVICE_STEPPER) {
+  // The posted type fields belong to the old type, so a type change starts from defaults.
+  if (type != sd.type) {
+    setSubdeviceType(sd, type);
+  } else if (sd.type == SUBDEVICE_STEPPER) {
     sd.stepper.driver = (StepperDriverType)server.arg("stdrv").toInt();
     sd.stepper.in1 = (uint8_t)server.arg("st1").toInt();
     sd.stepper.in2 = (uint8_t)server.arg("st2").toInt();
     sd.stepper.in3 = (uint8_t)server.arg("st3").toInt();
     sd.stepper.in4 = (uint8_t)server.arg("st4").toInt();
+    sd.stepper.stepPin = (uint8_t)server.arg("ststep").toInt();
+    sd.stepper.dirPin = (uint8_t)server.arg("stdirpin").toInt();
+    sd.stepper.enablePin = (uint8_t)server.arg("sten").toInt();
+    sd.stepper.microsteps = (uint16_t)server.arg("stmicro").toInt();
     sd.stepper.stepsPerRev = (uint16_t)server.arg("stspr").toInt();
     sd.stepper.maxDegPerSec = server.arg("stspd").toFloat();
+    sd.stepper.accelDegPerSec2 = server.arg("stacc").toFloat();
+    sd.stepper.jerkDegPerSec3 = server.arg("stjerk").toFloat();
     sd.stepper.limitsEnabled = server.hasArg("stlim");
     sd.stepper.minDeg = server.arg("stmin").toFloat();
     sd.stepper.maxDeg = server.arg("stmax").toFloat();
@@ -352,27 +429,45 @@ static void handleUpdateSubdevice() {
     sd.led.activeHigh = server.hasArg("ledah");
   } else if (sd.type == SUBDEVICE_PIXELS) {
     sd.pixels.driver = (PixelDriverType)server.arg("pxdrv").toInt();
+    sd.pixels.mode = (PixelMode)server.arg("pxmode").toInt();
     sd.pixels.pin = (uint8_t)server.arg("pxpin").toInt();
     sd.pixels.count = (uint16_t)server.arg("pxcount").toInt();
     sd.pixels.brightness = (uint8_t)server.arg("pxb").toInt();
+    sd.pixels.colorOrder = (PixelColorOrder)server.arg("pxorder").toInt();
+    sd.pixels.gamma = server.arg("pxgamma").toFloat();
   }
 
   sanity();
+  // Keep the running config rather than leave subdevices unreceived or dark.
+  if (refuseUnfittingConfig()) {
+    sd = previous;
+    return;
+  }
   saveConfig();
-  initSubdevices();
+  publishSubdeviceChanges();
   restartSacn();
 
   server.sendHeader("Location", "/subdevices");
   server.send(303);
 }
 
+#if USE_PIXELS
+static void handleSavePixelHeadroom() {
+  if (server.method() != HTTP_POST) { server.send(405, "text/plain", "Method Not Allowed"); return; }
+  cfg.pixelHeadroom = (uint16_t)server.arg("ph").toInt();
+  sanity();
+  saveConfig();
+  server.sendHeader("Location", "/subdevices");
+  server.send(303);
+}
+#endif
+
 static void handleDeleteSubdevice() {
   if (server.method() != HTTP_POST) { server.send(405, "text/plain", "Method Not Allowed"); return; }
   int idx;
   if (!parseSubdeviceIndex(idx)) return;
   deleteSubdevice((uint8_t)idx);
   saveConfig();
-  initSubdevices();
   restartSacn();
   server.sendHeader("Location", "/subdevices");
   server.send(303);
@@ -412,6 +507,9 @@ void setupWeb() {
   server.on("/savedmx", handleSaveDmx);
   server.on("/subdevices/add", handleAddSubdevice);
   server.on("/subdevices/update", handleUpdateSubdevice);
+#if USE_PIXELS
+  server.on("/subdevices/pixelheadroom", handleSavePixelHeadroom);
+#endif
   server.on("/subdevices/delete", handleDeleteSubdevice);
   server.on("/subdevices/test", handleTestSubdevice);
   server.on("/subdevices/home", handleHomeSubdevice);
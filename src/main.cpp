@@ -10,29 +10,62 @@
 #include <LittleFS.h>
 
 #include "core/config.h"
+#include "core/runtime_deadline.h"
 #include "core/subdevices.h"
 #include "core/web_ui.h"
 #include "platform/config_storage.h"
 #include "platform/dmx_sacn.h"
+#include "platform/runtime_wake.h"
 #include "platform/wifi_ota.h"
 
+// Longest the loops sleep with nothing due. The single-core loop also polls the web server
+// and OTA, so it wakes more often; the ingest task re-checks for receiver reconfiguration.
+static constexpr uint32_t LOOP_MAX_IDLE_MS = 5;
+static constexpr uint32_t INGEST_MAX_IDLE_MS = 20;
+static constexpr uint32_t RUNTIME_MAX_IDLE_MS = 100;
+
 #if defined(ARDUINO_ARCH_ESP32) && USE_ESP32_DUAL_CORE
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 
 static TaskHandle_t runtimeTaskHandle = nullptr;
 
+#if USE_SACN
+static TaskHandle_t ingestTaskHandle = nullptr;
+
+// Network stage on core 0 next to the WiFi/lwIP tasks: packet decode and merge never
+// run on the core that times the outputs.
+static void ingestLoopTask(void* param) {
+  (void)param;
+  while (true) {
+    handleSacnPackets();
+    RuntimeDeadline deadline;
+    deadlineBegin(deadline, millis(), INGEST_MAX_IDLE_MS);
+    sacnIngestDeadline(deadline);
+    sacnWaitForPackets(deadline.waitMs);
+  }
+}
+#endif
+
+// Sleeps until the next runtime deadline; ingest wakes it as soon as frames are handed over.
 static void runtimeLoopTask(void* param) {
   (void)param;
+  runtimeWakeBind();
   while (true) {
 #if USE_SACN
-    handleSacnPackets();
+    applySacnFrames();
 #endif
     tickSubdevices();
 #if USE_SACN
     enforceDmxLoss();
 #endif
-    vTaskDelay(1);
+    RuntimeDeadline deadline;
+    deadlineBegin(deadline, millis(), RUNTIME_MAX_IDLE_MS);
+    subdevicesNextDeadline(deadline);
+#if USE_SACN
+    dmxLossDeadline(deadline);
+#endif
+    runtimeWakeWait(deadline.waitMs);
   }
 }
 #endif
@@ -46,6 +79,7 @@ void setup() {
   sanity();
 
   initSubdevices();
+  Serial.println("Subdevice RAM: " + subdeviceMemoryReport());
   pinMode(cfg.homeButtonPin, INPUT_PULLUP);
 
   bool ok = connectSta(8000);
@@ -64,6 +98,16 @@ void setup() {
 #endif
 
 #if defined(ARDUINO_ARCH_ESP32) && USE_ESP32_DUAL_CORE
+#if USE_SACN
+  xTaskCreatePinnedToCore(
+      ingestLoopTask,
+      "sacn-ingest",
+      4096,
+      nullptr,
+      1,
+      &ingestTaskHandle,
+      0);
+#endif
   xTaskCreatePinnedToCore(
       runtimeLoopTask,
       "runtime-loop",
@@ -92,6 +136,16 @@ void loop() {
 #if USE_SACN
   enforceDmxLoss();
 #endif
-  yield();
+  // Sleep until the next deadline or packet instead of spinning.
+  RuntimeDeadline deadline;
+  deadlineBegin(deadline, millis(), LOOP_MAX_IDLE_MS);
+  subdevicesNextDeadline(deadline);
+#if USE_SACN
+  sacnIngestDeadline(deadline);
+  dmxLossDeadline(deadline);
+  sacnWaitForPackets(deadline.waitMs);
+#else
+  delay(deadline.waitMs);
+#endif
 #endif
 }
@@ -0,0 +1,47 @@
+#include "platform/esp32/artnet_receiver.h"
+
+#include "core/features.h"
+
+#if USE_SACN && USE_ARTNET
+
+#include <string.h>
+
+#include "core/config.h"
+#include "platform/compat/wifi.h"
+#include "platform/platform_services.h"
+#include "platform/esp32/udp_transport.h"
+
+static constexpr uint16_t ARTNET_OP_POLL = 0x2000;
+static constexpr uint16_t ARTNET_OP_POLL_REPLY = 0x2100;
+static constexpr uint16_t ARTNET_OP_DMX = 0x5000;
+static constexpr uint16_t ARTNET_PROTOCOL_VERSION = 14;
+static constexpr uint16_t ARTNET_DMX_HEADER_SIZE = 18;
+static constexpr uint16_t ARTNET_POLL_REPLY_SIZE = 239;
+static constexpr uint16_t ARTNET_MAX_PORT_ADDRESS = 0x7FFF;
+
+static const uint8_t ARTNET_ID[8] = {'A', 'r', 't', '-', 'N', 'e', 't', 0};
+
+alignas(4) static uint8_t packetBuffer[ARTNET_MAX_PACKET_SIZE];
+static uint8_t packetSourceId[16];
+static UdpEndpoint receiverEndpoint;
+
+static uint16_t advertisedUniverseOffset = 1;
+static uint16_t advertisedUniverses[MAX_UNIVERSES];
+static uint8_t advertisedUniverseCount = 0;
+
+static uint16_t readLe16(const uint8_t* p) {
+  return (uint16_t)(p[0] | ((uint16_t)p[1] << 8));
+}
+
+static uint16_t readBe16(const uint8_t* p) {
+  return (uint16_t)(((uint16_t)p[0] << 8) | p[1]);
+}
+
+bool artnetParseDmxPacket(const uint8_t*, size_t, uint16_t, uint32_t, uint8_t*, DmxPacketView&) { return false; }
+bool artnetReceiverBegin(uint16_t, const uint16_t*, uint8_t) { return false; }
+void artnetReceiverSetUniverses(uint16_t, const uint16_t*, uint8_t) {}
+void artnetReceiverStop() {}
+ArtnetPollResult artnetReceiverPoll(DmxPacketView&) { return ARTNET_POLL_EMPTY; }
+UdpEndpoint* artnetReceiverEndpoint() { return nullptr; }
+
+#endif
@@ -12,6 +12,48 @@ bool parseIp(const String& s, IPAddress& out) {
   return true;
 }
 
+static void sanitizeStepper(StepperRuntimeConfig& st) {
+  if (st.stepsPerRev < 200) st.stepsPerRev = 200;
+  if (st.stepsPerRev > 20000) st.stepsPerRev = 20000;
+  if (st.maxDegPerSec < 1.0f) st.maxDegPerSec = 1.0f;
+  if (st.maxDegPerSec > 5000.0f) st.maxDegPerSec = 5000.0f;
+  if (st.accelDegPerSec2 < 0.0f) st.accelDegPerSec2 = 0.0f;
+  if (st.accelDegPerSec2 > 100000.0f) st.accelDegPerSec2 = 100000.0f;
+  if (st.jerkDegPerSec3 < 0.0f) st.jerkDegPerSec3 = 0.0f;
+  if (st.jerkDegPerSec3 > 1000000.0f) st.jerkDegPerSec3 = 1000000.0f;
+  if (st.driver > STEPPER_DRIVER_STEP_DIR) st.driver = STEPPER_DRIVER_GENERIC;
+  if (st.microsteps < 1) st.microsteps = 1;
+  if (st.microsteps > 256) st.microsteps = 256;
+  if (st.seekMode > STEPPER_SEEK_DIRECTIONAL) st.seekMode = STEPPER_SEEK_SHORTEST_PATH;
+  if (st.seekForwardDirection > STEPPER_DIR_CCW) st.seekForwardDirection = STEPPER_DIR_CW;
+  if (st.seekReturnDirection > STEPPER_DIR_CCW) st.seekReturnDirection = STEPPER_DIR_CCW;
+  if (st.seekTieBreakMode > STEPPER_TIEBREAK_OPPOSITE_LAST) st.seekTieBreakMode = STEPPER_TIEBREAK_OPPOSITE_LAST;
+  if (st.minDeg > st.maxDeg) {
+    float t = st.minDeg;
+    st.minDeg = st.maxDeg;
+    st.maxDeg = t;
+  }
+  if (st.homeSwitchPin > 39 && st.homeSwitchPin != 255) st.homeSwitchPin = 255;
+}
+
+static void sanitizeDc(DcMotorRuntimeConfig& dc) {
+  if (dc.pwmBits < 1) dc.pwmBits = 1;
+  if (dc.pwmBits > 8) dc.pwmBits = 8;
+  if (dc.pwmChannel > 15) dc.pwmChannel = 15;
+  if (dc.pwmHz < 1) dc.pwmHz = 1;
+  if (dc.rampBufferMs > 10000) dc.rampBufferMs = 10000;
+  if (dc.driver > DC_DRIVER_GENERIC) dc.driver = DC_DRIVER_GENERIC;
+}
+
+static void sanitizePixels(PixelRuntimeConfig& px) {
+  if (px.count > MAX_PIXELS_PER_STRIP) px.count = MAX_PIXELS_PER_STRIP;
+  if (px.driver > PIXEL_DRIVER_GENERIC) px.driver = PIXEL_DRIVER_GENERIC;
+  if (px.mode > PIXEL_MODE_EFFECT) px.mode = PIXEL_MODE_SOLID;
+  if (px.colorOrder > PIXEL_ORDER_BGR) px.colorOrder = PIXEL_ORDER_GRB;
+  if (px.gamma < 1.0f) px.gamma = 1.0f;
+  if (px.gamma > 3.0f) px.gamma = 3.0f;
+}
+
 void sanity() {
   if (cfg.universe < 1) cfg.universe = 1;
   if (cfg.startAddr < 1) cfg.startAddr = 1;
@@ -19,6 +61,8 @@ void sanity() {
   if (cfg.lossTimeoutMs < 100) cfg.lossTimeoutMs = 100;
   if (cfg.lossTimeoutMs > 60000) cfg.lossTimeoutMs = 60000;
   if (cfg.sacnBufferMs > 10000) cfg.sacnBufferMs = 10000;
+  if (cfg.artnetUniverseOffset > 63999) cfg.artnetUniverseOffset = 63999;
+  if (cfg.pixelHeadroom > MAX_PIXELS_PER_STRIP) cfg.pixelHeadroom = MAX_PIXELS_PER_STRIP;
   if (cfg.subdeviceCount > MAX_SUBDEVICES) cfg.subdeviceCount = MAX_SUBDEVICES;
 
   for (uint8_t i = 0; i < cfg.subdeviceCount; i++) {
@@ -26,105 +70,165 @@ void sanity() {
     if (sd.map.universe < 1) sd.map.universe = 1;
     if (sd.map.startAddr < 1) sd.map.startAddr = 1;
     if (sd.map.startAddr > 512) sd.map.startAddr = 512;
-    if (sd.dc.pwmBits < 1) sd.dc.pwmBits = 1;
-    if (sd.dc.pwmBits > 8) sd.dc.pwmBits = 8;
-    if (sd.dc.pwmChannel > 15) sd.dc.pwmChannel = 15;
-    if (sd.dc.pwmHz < 1) sd.dc.pwmHz = 1;
-    if (sd.dc.rampBufferMs > 10000) sd.dc.rampBufferMs = 10000;
-    if (sd.pixels.count > 1024) sd.pixels.count = 1024;
-    if (sd.stepper.stepsPerRev < 200) sd.stepper.stepsPerRev = 200;
-    if (sd.stepper.stepsPerRev > 20000) sd.stepper.stepsPerRev = 20000;
-    if (sd.stepper.maxDegPerSec < 1.0f) sd.stepper.maxDegPerSec = 1.0f;
-    if (sd.stepper.maxDegPerSec > 5000.0f) sd.stepper.maxDegPerSec = 5000.0f;
-    if (sd.stepper.driver > STEPPER_DRIVER_GENERIC) sd.stepper.driver = STEPPER_DRIVER_GENERIC;
-    if (sd.stepper.seekMode > STEPPER_SEEK_DIRECTIONAL) sd.stepper.seekMode = STEPPER_SEEK_SHORTEST_PATH;
-    if (sd.stepper.seekForwardDirection > STEPPER_DIR_CCW) sd.stepper.seekForwardDirection = STEPPER_DIR_CW;
-    if (sd.stepper.seekReturnDirection > STEPPER_DIR_CCW) sd.stepper.seekReturnDirection = STEPPER_DIR_CCW;
-    if (sd.stepper.seekTieBreakMode > STEPPER_TIEBREAK_OPPOSITE_LAST) sd.stepper.seekTieBreakMode = STEPPER_TIEBREAK_OPPOSITE_LAST;
-    if (sd.dc.driver > DC_DRIVER_GENERIC) sd.dc.driver = DC_DRIVER_GENERIC;
-    if (sd.pixels.driver > PIXEL_DRIVER_GENERIC) sd.pixels.driver = PIXEL_DRIVER_GENERIC;
-    if (sd.stepper.minDeg > sd.stepper.maxDeg) {
-      float t = sd.stepper.minDeg;
-      sd.stepper.minDeg = sd.stepper.maxDeg;
-      sd.stepper.maxDeg = t;
+    // Only the live payload is clamped; the other union members alias it.
+    switch (sd.type) {
+      case SUBDEVICE_STEPPER: sanitizeStepper(sd.stepper); break;
+      case SUBDEVICE_DC_MOTOR: sanitizeDc(sd.dc); break;
+      case SUBDEVICE_PIXELS: sanitizePixels(sd.pixels); break;
+      default: break;
     }
-    if (sd.stepper.homeSwitchPin > 39 && sd.stepper.homeSwitchPin != 255) sd.stepper.homeSwitchPin = 255;
   }
 }
 
-static void loadSubdevice(JsonObject obj, SubdeviceConfig& sd) {
-  sd.enabled = obj["enabled"] | true;
-  sd.type = (SubdeviceType)((int)obj["type"] | (int)SUBDEVICE_STEPPER);
-  String name = obj["name"].is<const char*>() ? String(obj["name"].as<const char*>()) : String("subdevice");
-  name.toCharArray(sd.name, sizeof(sd.name));
-
-  sd.map.universe = obj["map"]["universe"] | 1;
-  sd.map.startAddr = obj["map"]["startAddr"] | 1;
-
-  sd.dc.driver = (DcDriverType)((int)obj["dc"]["driver"] | (int)sd.dc.driver);
-  sd.dc.dirPin = obj["dc"]["dirPin"] | sd.dc.dirPin;
-  sd.dc.pwmPin = obj["dc"]["pwmPin"] | sd.dc.pwmPin;
-  sd.dc.pwmChannel = obj["dc"]["pwmChannel"] | sd.dc.pwmChannel;
-  sd.dc.pwmHz = obj["dc"]["pwmHz"] | sd.dc.pwmHz;
-  sd.dc.pwmBits = obj["dc"]["pwmBits"] | sd.dc.pwmBits;
-  sd.dc.deadband = obj["dc"]["deadband"] | sd.dc.deadband;
-  sd.dc.maxPwm = obj["dc"]["maxPwm"] | sd.dc.maxPwm;
-  sd.dc.rampBufferMs = obj["dc"]["rampBufferMs"] | sd.dc.rampBufferMs;
-  sd.dc.command16Bit = obj["dc"]["command16Bit"] | sd.dc.command16Bit;
-
-  sd.stepper.driver = (StepperDriverType)((int)obj["stepper"]["driver"] | (int)sd.stepper.driver);
-  sd.stepper.in1 = obj["stepper"]["in1"] | sd.stepper.in1;
-  sd.stepper.in2 = obj["stepper"]["in2"] | sd.stepper.in2;
-  sd.stepper.in3 = obj["stepper"]["in3"] | sd.stepper.in3;
-  sd.stepper.in4 = obj["stepper"]["in4"] | sd.stepper.in4;
-  sd.stepper.stepsPerRev = obj["stepper"]["stepsPerRev"] | sd.stepper.stepsPerRev;
-  sd.stepper.maxDegPerSec = obj["stepper"]["maxDegPerSec"] | sd.stepper.maxDegPerSec;
-  sd.stepper.limitsEnabled = obj["stepper"]["limitsEnabled"] | sd.stepper.limitsEnabled;
-  sd.stepper.minDeg = obj["stepper"]["minDeg"] | sd.stepper.minDeg;
-  sd.stepper.maxDeg = obj["stepper"]["maxDeg"] | sd.stepper.maxDeg;
-  sd.stepper.homeOffsetSteps = obj["stepper"]["homeOffsetSteps"] | sd.stepper.homeOffsetSteps;
-  sd.stepper.homeSwitchEnabled = obj["stepper"]["homeSwitchEnabled"] | sd.stepper.homeSwitchEnabled;
-  sd.stepper.homeSwitchPin = obj["stepper"]["homeSwitchPin"] | sd.stepper.homeSwitchPin;
-  sd.stepper.homeSwitchActiveLow = obj["stepper"]["homeSwitchActiveLow"] | sd.stepper.homeSwitchActiveLow;
-  sd.stepper.position16Bit = obj["stepper"]["position16Bit"] | sd.stepper.position16Bit;
-
-  JsonVariant seekModeVar = obj["stepper"]["seekMode"];
-  JsonVariant seekForwardDirVar = obj["stepper"]["seekForwardDirection"];
-  JsonVariant seekReturnDirVar = obj["stepper"]["seekReturnDirection"];
-  JsonVariant seekTieBreakVar = obj["stepper"]["seekTieBreakMode"];
+static void loadStepper(JsonObject obj, StepperRuntimeConfig& st) {
+  st.driver = (StepperDriverType)((int)obj["driver"] | (int)st.driver);
+  st.in1 = obj["in1"] | st.in1;
+  st.in2 = obj["in2"] | st.in2;
+  st.in3 = obj["in3"] | st.in3;
+  st.in4 = obj["in4"] | st.in4;
+  st.stepsPerRev = obj["stepsPerRev"] | st.stepsPerRev;
+  st.stepPin = obj["stepPin"] | st.stepPin;
+  st.dirPin = obj["dirPin"] | st.dirPin;
+  st.enablePin = obj["enablePin"] | st.enablePin;
+  st.microsteps = obj["microsteps"] | st.microsteps;
+  st.maxDegPerSec = obj["maxDegPerSec"] | st.maxDegPerSec;
+  st.accelDegPerSec2 = obj["accelDegPerSec2"] | st.accelDegPerSec2;
+  st.jerkDegPerSec3 = obj["jerkDegPerSec3"] | st.jerkDegPerSec3;
+  st.limitsEnabled = obj["limitsEnabled"] | st.limitsEnabled;
+  st.minDeg = obj["minDeg"] | st.minDeg;
+  st.maxDeg = obj["maxDeg"] | st.maxDeg;
+  st.homeOffsetSteps = obj["homeOffsetSteps"] | st.homeOffsetSteps;
+  st.homeSwitchEnabled = obj["homeSwitchEnabled"] | st.homeSwitchEnabled;
+  st.homeSwitchPin = obj["homeSwitchPin"] | st.homeSwitchPin;
+  st.homeSwitchActiveLow = obj["homeSwitchActiveLow"] | st.homeSwitchActiveLow;
+  st.position16Bit = obj["position16Bit"] | st.position16Bit;
+
+  JsonVariant seekModeVar = obj["seekMode"];
+  JsonVariant seekForwardDirVar = obj["seekForwardDirection"];
+  JsonVariant seekReturnDirVar = obj["seekReturnDirection"];
+  JsonVariant seekTieBreakVar = obj["seekTieBreakMode"];
 
   if (!seekModeVar.isNull()) {
-    sd.stepper.seekMode = (StepperSeekMode)((int)seekModeVar | (int)sd.stepper.seekMode);
+    st.seekMode = (StepperSeekMode)((int)seekModeVar | (int)st.seekMode);
   }
   if (!seekForwardDirVar.isNull()) {
-    sd.stepper.seekForwardDirection = (StepperDirection)((int)seekForwardDirVar | (int)sd.stepper.seekForwardDirection);
+    st.seekForwardDirection = (StepperDirection)((int)seekForwardDirVar | (int)st.seekForwardDirection);
   }
   if (!seekReturnDirVar.isNull()) {
-    sd.stepper.seekReturnDirection = (StepperDirection)((int)seekReturnDirVar | (int)sd.stepper.seekReturnDirection);
+    st.seekReturnDirection = (StepperDirection)((int)seekReturnDirVar | (int)st.seekReturnDirection);
   }
   if (!seekTieBreakVar.isNull()) {
-    sd.stepper.seekTieBreakMode = (StepperTieBreakMode)((int)seekTieBreakVar | (int)sd.stepper.seekTieBreakMode);
+    st.seekTieBreakMode = (StepperTieBreakMode)((int)seekTieBreakVar | (int)st.seekTieBreakMode);
   }
 
   // Legacy migration path: map old seekClockwise to directional forward/return config.
-  JsonVariant legacySeekClockwise = obj["stepper"]["seekClockwise"];
+  JsonVariant legacySeekClockwise = obj["seekClockwise"];
   if (seekModeVar.isNull() && !legacySeekClockwise.isNull()) {
     bool seekClockwise = legacySeekClockwise.as<bool>();
-    sd.stepper.seekMode = STEPPER_SEEK_DIRECTIONAL;
-    sd.stepper.seekForwardDirection = seekClockwise ? STEPPER_DIR_CW : STEPPER_DIR_CCW;
-    sd.stepper.seekReturnDirection = seekClockwise ? STEPPER_DIR_CW : STEPPER_DIR_CCW;
+    st.seekMode = STEPPER_SEEK_DIRECTIONAL;
+    st.seekForwardDirection = seekClockwise ? STEPPER_DIR_CW : STEPPER_DIR_CCW;
+    st.seekReturnDirection = seekClockwise ? STEPPER_DIR_CW : STEPPER_DIR_CCW;
+  }
+}
+
+static void loadDc(JsonObject obj, DcMotorRuntimeConfig& dc) {
+  dc.driver = (DcDriverType)((int)obj["driver"] | (int)dc.driver);
+  dc.dirPin = obj["dirPin"] | dc.dirPin;
+  dc.pwmPin = obj["pwmPin"] | dc.pwmPin;
+  dc.pwmChannel = obj["pwmChannel"] | dc.pwmChannel;
+  dc.pwmHz = obj["pwmHz"] | dc.pwmHz;
+  dc.pwmBits = obj["pwmBits"] | dc.pwmBits;
+  dc.deadband = obj["deadband"] | dc.deadband;
+  dc.maxPwm = obj["maxPwm"] | dc.maxPwm;
+  dc.rampBufferMs = obj["rampBufferMs"] | dc.rampBufferMs;
+  dc.command16Bit = obj["command16Bit"] | dc.command16Bit;
+}
+
+static void loadPixels(JsonObject obj, PixelRuntimeConfig& px) {
+  px.driver = (PixelDriverType)((int)obj["driver"] | (int)px.driver);
+  px.mode = (PixelMode)((int)obj["mode"] | (int)px.mode);
+  px.colorOrder = (PixelColorOrder)((int)obj["colorOrder"] | (int)px.colorOrder);
+  px.pin = obj["pin"] | px.pin;
+  px.count = obj["count"] | px.count;
+  px.brightness = obj["brightness"] | px.brightness;
+  px.gamma = obj["gamma"] | px.gamma;
+}
+
+static void loadSubdevice(JsonObject obj, SubdeviceConfig& sd) {
+  sd.enabled = obj["enabled"] | true;
+  setSubdeviceType(sd, (SubdeviceType)((int)obj["type"] | (int)SUBDEVICE_STEPPER));
+  String name = obj["name"].is<const char*>() ? String(obj["name"].as<const char*>()) : String("subdevice");
+  name.toCharArray(sd.name, sizeof(sd.name));
+
+  sd.map.universe = obj["map"]["universe"] | 1;
+  sd.map.startAddr = obj["map"]["startAddr"] | 1;
+
+  // Only the live payload is read; older files carry every type's section.
+  switch (sd.type) {
+    case SUBDEVICE_STEPPER: loadStepper(obj["stepper"].as<JsonObject>(), sd.stepper); break;
+    case SUBDEVICE_DC_MOTOR: loadDc(obj["dc"].as<JsonObject>(), sd.dc); break;
+    case SUBDEVICE_RELAY:
+      sd.relay.pin = obj["relay"]["pin"] | sd.relay.pin;
+      sd.relay.activeHigh = obj["relay"]["activeHigh"] | sd.relay.activeHigh;
+      break;
+    case SUBDEVICE_LED:
+      sd.led.pin = obj["led"]["pin"] | sd.led.pin;
+      sd.led.activeHigh = obj["led"]["activeHigh"] | sd.led.activeHigh;
+      break;
+    case SUBDEVICE_PIXELS: loadPixels(obj["pixels"].as<JsonObject>(), sd.pixels); break;
+    default: break;
   }
+}
 
-  sd.relay.pin = obj["relay"]["pin"] | sd.relay.pin;
-  sd.relay.activeHigh = obj["relay"]["activeHigh"] | sd.relay.activeHigh;
+static void saveStepper(JsonObject obj, const StepperRuntimeConfig& st) {
+  obj["driver"] = (int)st.driver;
+  obj["in1"] = st.in1;
+  obj["in2"] = st.in2;
+  obj["in3"] = st.in3;
+  obj["in4"] = st.in4;
+  obj["stepsPerRev"] = st.stepsPerRev;
+  obj["stepPin"] = st.stepPin;
+  obj["dirPin"] = st.dirPin;
+  obj["enablePin"] = st.enablePin;
+  obj["microsteps"] = st.microsteps;
+  obj["maxDegPerSec"] = st.maxDegPerSec;
+  obj["accelDegPerSec2"] = st.accelDegPerSec2;
+  obj["jerkDegPerSec3"] = st.jerkDegPerSec3;
+  obj["limitsEnabled"] = st.limitsEnabled;
+  obj["minDeg"] = st.minDeg;
+  obj["maxDeg"] = st.maxDeg;
+  obj["homeOffsetSteps"] = st.homeOffsetSteps;
+  obj["homeSwitchEnabled"] = st.homeSwitchEnabled;
+  obj["homeSwitchPin"] = st.homeSwitchPin;
+  obj["homeSwitchActiveLow"] = st.homeSwitchActiveLow;
+  obj["position16Bit"] = st.position16Bit;
+  obj["seekMode"] = (int)st.seekMode;
+  obj["seekForwardDirection"] = (int)st.seekForwardDirection;
+  obj["seekReturnDirection"] = (int)st.seekReturnDirection;
+  obj["seekTieBreakMode"] = (int)st.seekTieBreakMode;
+}
 
-  sd.led.pin = obj["led"]["pin"] | sd.led.pin;
-  sd.led.activeHigh = obj["led"]["activeHigh"] | sd.led.activeHigh;
+static void saveDc(JsonObject obj, const DcMotorRuntimeConfig& dc) {
+  obj["driver"] = (int)dc.driver;
+  obj["dirPin"] = dc.dirPin;
+  obj["pwmPin"] = dc.pwmPin;
+  obj["pwmChannel"] = dc.pwmChannel;
+  obj["pwmHz"] = dc.pwmHz;
+  obj["pwmBits"] = dc.pwmBits;
+  obj["deadband"] = dc.deadband;
+  obj["maxPwm"] = dc.maxPwm;
+  obj["rampBufferMs"] = dc.rampBufferMs;
+  obj["command16Bit"] = dc.command16Bit;
+}
 
-  sd.pixels.driver = (PixelDriverType)((int)obj["pixels"]["driver"] | (int)sd.pixels.driver);
-  sd.pixels.pin = obj["pixels"]["pin"] | sd.pixels.pin;
-  sd.pixels.count = obj["pixels"]["count"] | sd.pixels.count;
-  sd.pixels.brightness = obj["pixels"]["brightness"] | sd.pixels.brightness;
+static void savePixels(JsonObject obj, const PixelRuntimeConfig& px) {
+  obj["driver"] = (int)px.driver;
+  obj["mode"] = (int)px.mode;
+  obj["colorOrder"] = (int)px.colorOrder;
+  obj["pin"] = px.pin;
+  obj["count"] = px.count;
+  obj["brightness"] = px.brightness;
+  obj["gamma"] = px.gamma;
 }
 
 static void saveSubdevice(JsonArray arr, const SubdeviceConfig& sd) {
@@ -135,47 +239,20 @@ static void saveSubdevice(JsonArray arr, const SubdeviceConfig& sd) {
   obj["map"]["universe"] = sd.map.universe;
   obj["map"]["startAddr"] = sd.map.startAddr;
 
-  obj["dc"]["driver"] = (int)sd.dc.driver;
-  obj["dc"]["dirPin"] = sd.dc.dirPin;
-  obj["dc"]["pwmPin"] = sd.dc.pwmPin;
-  obj["dc"]["pwmChannel"] = sd.dc.pwmChannel;
-  obj["dc"]["pwmHz"] = sd.dc.pwmHz;
-  obj["dc"]["pwmBits"] = sd.dc.pwmBits;
-  obj["dc"]["deadband"] = sd.dc.deadband;
-  obj["dc"]["maxPwm"] = sd.dc.maxPwm;
-  obj["dc"]["rampBufferMs"] = sd.dc.rampBufferMs;
-  obj["dc"]["command16Bit"] = sd.dc.command16Bit;
-
-  obj["stepper"]["driver"] = (int)sd.stepper.driver;
-  obj["stepper"]["in1"] = sd.stepper.in1;
-  obj["stepper"]["in2"] = sd.stepper.in2;
-  obj["stepper"]["in3"] = sd.stepper.in3;
-  obj["stepper"]["in4"] = sd.stepper.in4;
-  obj["stepper"]["stepsPerRev"] = sd.stepper.stepsPerRev;
-  obj["stepper"]["maxDegPerSec"] = sd.stepper.maxDegPerSec;
-  obj["stepper"]["limitsEnabled"] = sd.stepper.limitsEnabled;
-  obj["stepper"]["minDeg"] = sd.stepper.minDeg;
-  obj["stepper"]["maxDeg"] = sd.stepper.maxDeg;
-  obj["stepper"]["homeOffsetSteps"] = sd.stepper.homeOffsetSteps;
-  obj["stepper"]["homeSwitchEnabled"] = sd.stepper.homeSwitchEnabled;
-  obj["stepper"]["homeSwitchPin"] = sd.stepper.homeSwitchPin;
-  obj["stepper"]["homeSwitchActiveLow"] = sd.stepper.homeSwitchActiveLow;
-  obj["stepper"]["position16Bit"] = sd.stepper.position16Bit;
-  obj["stepper"]["seekMode"] = (int)sd.stepper.seekMode;
-  obj["stepper"]["seekForwardDirection"] = (int)sd.stepper.seekForwardDirection;
-  obj["stepper"]["seekReturnDirection"] = (int)sd.stepper.seekReturnDirection;
-  obj["stepper"]["seekTieBreakMode"] = (int)sd.stepper.seekTieBreakMode;
-
-  obj["relay"]["pin"] = sd.relay.pin;
-  obj["relay"]["activeHigh"] = sd.relay.activeHigh;
-
-  obj["led"]["pin"] = sd.led.pin;
-  obj["led"]["activeHigh"] = sd.led.activeHigh;
-
-  obj["pixels"]["driver"] = (int)sd.pixels.driver;
-  obj["pixels"]["pin"] = sd.pixels.pin;
-  obj["pixels"]["count"] = sd.pixels.count;
-  obj["pixels"]["brightness"] = sd.pixels.brightness;
+  switch (sd.type) {
+    case SUBDEVICE_STEPPER: saveStepper(obj["stepper"].to<JsonObject>(), sd.stepper); break;
+    case SUBDEVICE_DC_MOTOR: saveDc(obj["dc"].to<JsonObject>(), sd.dc); break;
+    case SUBDEVICE_RELAY:
+      obj["relay"]["pin"] = sd.relay.pin;
+      obj["relay"]["activeHigh"] = sd.relay.activeHigh;
+      break;
+    case SUBDEVICE_LED:
+      obj["led"]["pin"] = sd.led.pin;
+      obj["led"]["activeHigh"] = sd.led.activeHigh;
+      break;
+    case SUBDEVICE_PIXELS: savePixels(obj["pixels"].to<JsonObject>(), sd.pixels); break;
+    default: break;
+  }
 }
 
 bool loadConfig() {
@@ -220,7 +297,9 @@ bool loadConfig() {
   cfg.lossMode = (DmxLossMode)((int)doc["dmx"]["lossMode"] | (int)LOSS_FORCE_OFF);
   cfg.lossTimeoutMs = doc["dmx"]["lossTimeoutMs"] | 1000;
   cfg.sacnBufferMs = doc["dmx"]["sacnBufferMs"] | 0;
+  cfg.artnetUniverseOffset = doc["dmx"]["artnetUniverseOffset"] | 1;
   cfg.homeButtonPin = doc["hardware"]["homeButtonPin"] | cfg.homeButtonPin;
+  cfg.pixelHeadroom = doc["hardware"]["pixelHeadroom"] | 0;
 
   cfg.subdeviceCount = 0;
   if (doc["subdevices"].is<JsonArray>()) {
@@ -265,7 +344,9 @@ bool saveConfig() {
   doc["dmx"]["lossMode"] = (int)cfg.lossMode;
   doc["dmx"]["lossTimeoutMs"] = cfg.lossTimeoutMs;
   doc["dmx"]["sacnBufferMs"] = cfg.sacnBufferMs;
+  doc["dmx"]["artnetUniverseOffset"] = cfg.artnetUniverseOffset;
   doc["hardware"]["homeButtonPin"] = cfg.homeButtonPin;
+  doc["hardware"]["pixelHeadroom"] = cfg.pixelHeadroom;
 
   JsonArray arr = doc["subdevices"].to<JsonArray>();
   for (uint8_t i = 0; i < cfg.subdeviceCount; i++) {
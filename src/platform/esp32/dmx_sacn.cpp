@@ -4,153 +4,694 @@
 
 #if USE_SACN
 
-#include <ESPAsyncE131.h>
 #include <string.h>
-#include <lwip/def.h>
+#include <atomic>
+#include <new>
 
 #include "core/config.h"
 #include "core/subdevices.h"
+#include "platform/esp32/e131_receiver.h"
+#include "platform/esp32/udp_transport.h"
+#include "platform/runtime_wake.h"
+
+#if USE_ARTNET
+#include "platform/esp32/artnet_receiver.h"
+#endif
+
+// Upper bound on datagrams drained per handleSacnPackets() call so multicast bursts
+// cannot starve subdevice ticks.
+static constexpr uint8_t SACN_MAX_PACKETS_PER_POLL = 16;
+
+// Frames tagged with a sync address are held until the matching sync packet arrives.
+// If it does not arrive within SACN_SYNC_TIMEOUT_MS the frame is applied on its own; once
+// no sync packet has been seen for SACN_SYNC_LOSS_MS, tagged frames are not held at all.
+static constexpr uint32_t SACN_SYNC_TIMEOUT_MS = 50;
+static constexpr uint32_t SACN_SYNC_LOSS_MS = 1000;
+
+// Bounded per-universe source slots (e.g. main + backup console), keyed by CID. A source
+// that stops sending for SACN_SOURCE_TIMEOUT_MS (E1.31 data loss timeout) is dropped.
+static constexpr uint8_t SACN_MAX_SOURCES_PER_UNIVERSE = 2;
+static constexpr uint32_t SACN_SOURCE_TIMEOUT_MS = 2500;
+
+static constexpr uint16_t SACN_SLOT_WORDS = SACN_UNIVERSE_SLOTS / 4;
+static constexpr uint8_t SACN_WORD_MASK_WORDS = SACN_SLOT_WORDS / 32;
+
+// With the dual-core split, ingest runs in its own network task and hands finished
+// universe frames to the core-1 runtime task through per-universe triple buffers.
+#if defined(ARDUINO_ARCH_ESP32) && USE_ESP32_DUAL_CORE
+#define SACN_FRAME_HANDOFF 1
+#else
+#define SACN_FRAME_HANDOFF 0
+#endif
 
-static ESPAsyncE131 e131(4);
 static bool e131Started = false;
-static bool haveDmx = false;
-static uint32_t lastDmxMs = 0;
+static SacnMode sacnModeInUse = SACN_UNICAST;
+// Written by ingest, read (and cleared on loss) by the runtime task.
+static std::atomic<bool> haveDmx(false);
+static std::atomic<uint32_t> lastDmxMs(0);
 
 static uint32_t sacnPacketCount = 0;
 static uint16_t lastUniverseSeenValue = 0;
 
+// Sync addresses tagged frames referred to recently. Sources or universes may use different
+// ones; each keeps its own sync-seen state, and an entry is only reused once no frame has
+// been tagged with its address for SACN_SYNC_LOSS_MS, so the receiver's sync groups change
+// with the set of addresses and not with every packet.
+struct SyncAddressState {
+  uint16_t address = 0;
+  bool seen = false;
+  uint32_t lastSyncMs = 0;
+  uint32_t lastTaggedMs = 0;
+};
+
+static SyncAddressState syncAddresses[E131_MAX_SYNC_UNIVERSES];
+
+struct SacnSource {
+  bool active = false;
+  uint8_t cid[16] = {0};
+  uint8_t priority = 0;
+  uint8_t lastSeq = 0;
+  uint32_t lastSeenMs = 0;
+  // Sync address of the source's newest data packet (0 = not synchronized).
+  uint16_t syncAddress = 0;
+  alignas(4) uint8_t slots[SACN_UNIVERSE_SLOTS] = {0};
+};
+
 struct BufferedUniverseFrame {
   bool hasFrame = false;
   bool dirty = false;
   uint16_t universe = 0;
   uint32_t lastApplyMs = 0;
   uint32_t lastSeenMs = 0;
-  uint8_t lastSeq = 0;
-  bool seqValid = false;
-  uint8_t slots[512] = {0};
+  uint8_t topPriority = 0;
+  SacnSource sources[SACN_MAX_SOURCES_PER_UNIVERSE];
+  // Follows the sources at topPriority only; a losing backup or an untagged Art-Net sender
+  // must not release held frames.
+  uint16_t syncAddress = 0;
+  bool syncHeld = false;
+  uint32_t syncHeldSinceMs = 0;
+  uint32_t changedSlots[SACN_SLOT_MASK_WORDS] = {0};
+  alignas(4) uint8_t slots[SACN_UNIVERSE_SLOTS] = {0};
 };
 
-static constexpr uint8_t MAX_BUFFERED_UNIVERSES = 4;
-static BufferedUniverseFrame bufferedFrames[MAX_BUFFERED_UNIVERSES];
-
-static BufferedUniverseFrame* findBufferedFrame(uint16_t universe, bool create, uint32_t nowMs) {
-  for (uint8_t i = 0; i < MAX_BUFFERED_UNIVERSES; i++) {
-    if (bufferedFrames[i].universe == universe && bufferedFrames[i].universe != 0) return &bufferedFrames[i];
-  }
-  if (!create) return nullptr;
-
-  for (uint8_t i = 0; i < MAX_BUFFERED_UNIVERSES; i++) {
-    if (bufferedFrames[i].universe == 0) {
-      bufferedFrames[i].universe = universe;
-      bufferedFrames[i].hasFrame = false;
-      bufferedFrames[i].dirty = false;
-      bufferedFrames[i].lastApplyMs = 0;
-      bufferedFrames[i].lastSeenMs = nowMs;
-      bufferedFrames[i].lastSeq = 0;
-      bufferedFrames[i].seqValid = false;
-      return &bufferedFrames[i];
+// Frame table holds one entry per configured universe and is allocated when sACN starts
+// (grown only when a config needs more universes). Lookup goes through an open-addressed
+// universe -> frame index table, so packet routing is O(1) regardless of universe count.
+static constexpr uint16_t universeLookupSizeFor(uint16_t entries, uint16_t size = 1) {
+  return size >= entries * 2 ? size : universeLookupSizeFor(entries, (uint16_t)(size << 1));
+}
+
+static constexpr uint16_t UNIVERSE_LOOKUP_SIZE = universeLookupSizeFor(MAX_UNIVERSES);
+static constexpr uint8_t UNIVERSE_LOOKUP_EMPTY = 0xFF;
+static constexpr uint16_t UNIVERSE_FREE = 0;
+static_assert(MAX_UNIVERSES < UNIVERSE_LOOKUP_EMPTY, "frame index must fit the lookup table");
+
+static BufferedUniverseFrame* bufferedFrames = nullptr;
+static uint8_t bufferedFrameCapacity = 0;
+static uint8_t bufferedFrameCount = 0;
+static uint8_t universeLookup[UNIVERSE_LOOKUP_SIZE];
+
+static uint16_t universeLookupHash(uint16_t universe) {
+  return (uint16_t)(((uint32_t)universe * 40503UL) & (UNIVERSE_LOOKUP_SIZE - 1));
+}
+
+// Word-wide diff of an incoming universe against the source's copy. Changed words are
+// copied in place and flagged in changedWords (bit n covers slots 4n..4n+3).
+// Slots past incomingCount (short universes) are treated as zero.
+static bool copyIncomingSlots(SacnSource& source, const uint8_t* incoming, uint16_t incomingCount, uint32_t* changedWords) {
+  bool changed = false;
+  for (uint16_t offset = 0; offset < SACN_UNIVERSE_SLOTS; offset += 4) {
+    uint32_t oldWord;
+    uint32_t newWord = 0;
+    memcpy(&oldWord, &source.slots[offset], sizeof(oldWord));
+    if (offset + 4 <= incomingCount) {
+      memcpy(&newWord, &incoming[offset], sizeof(newWord));
+    } else if (offset < incomingCount) {
+      memcpy(&newWord, &incoming[offset], incomingCount - offset);
     }
+    if (oldWord == newWord) continue;
+
+    memcpy(&source.slots[offset], &newWord, sizeof(newWord));
+    uint16_t word = offset >> 2;
+    changedWords[word >> 5] |= (1UL << (word & 31));
+    changed = true;
   }
+  return changed;
+}
 
-  // Buffer is full: replace the stalest slot so active universes continue updating.
-  uint8_t stalest = 0;
-  uint32_t stalestAge = nowMs - bufferedFrames[0].lastSeenMs;
-  for (uint8_t i = 1; i < MAX_BUFFERED_UNIVERSES; i++) {
-    uint32_t age = nowMs - bufferedFrames[i].lastSeenMs;
-    if (age > stalestAge) {
-      stalest = i;
-      stalestAge = age;
+// Highest priority wins; sources sharing the top priority are merged HTP per slot.
+static uint32_t mergedWord(const BufferedUniverseFrame& frame, uint16_t offset) {
+  uint8_t merged[4] = {0, 0, 0, 0};
+  for (const auto& source : frame.sources) {
+    if (!source.active || source.priority != frame.topPriority) continue;
+    for (uint8_t b = 0; b < 4; b++) {
+      if (source.slots[offset + b] > merged[b]) merged[b] = source.slots[offset + b];
     }
   }
+  uint32_t word;
+  memcpy(&word, merged, sizeof(word));
+  return word;
+}
 
-  bufferedFrames[stalest] = BufferedUniverseFrame();
-  bufferedFrames[stalest].universe = universe;
-  bufferedFrames[stalest].lastSeenMs = nowMs;
-  return &bufferedFrames[stalest];
+// Stores a merged word in the frame and OR-s every differing slot into the frame's
+// changed-slot mask, so slots that change across several packets between applies are kept.
+static bool storeMergedWord(BufferedUniverseFrame& frame, uint16_t offset, uint32_t newWord) {
+  uint32_t oldWord;
+  memcpy(&oldWord, &frame.slots[offset], sizeof(oldWord));
+  uint32_t diff = oldWord ^ newWord;
+  if (diff == 0) return false;
+
+  memcpy(&frame.slots[offset], &newWord, sizeof(newWord));
+  for (uint8_t b = 0; b < 4; b++) {
+    if ((diff >> (8 * b)) & 0xFF) {
+      uint16_t slot = offset + b;
+      frame.changedSlots[slot >> 5] |= (1UL << (slot & 31));
+    }
+  }
+  return true;
 }
 
-void startSacn() {
-  e131Started = false;
-  uint16_t minU = subdeviceMinUniverse();
-  uint16_t maxU = subdeviceMaxUniverse();
-  uint16_t range = (maxU >= minU) ? (maxU - minU + 1) : 1;
-  if (range < 1) range = 1;
-  if (range > 4) range = 4;
+static bool mergeChangedWords(BufferedUniverseFrame& frame, const uint32_t* changedWords) {
+  bool changed = false;
+  for (uint8_t m = 0; m < SACN_WORD_MASK_WORDS; m++) {
+    uint32_t bits = changedWords[m];
+    while (bits) {
+      uint8_t bit = (uint8_t)__builtin_ctz(bits);
+      bits &= bits - 1;
+      uint16_t offset = (uint16_t)(((m << 5) + bit) << 2);
+      if (storeMergedWord(frame, offset, mergedWord(frame, offset))) changed = true;
+    }
+  }
+  return changed;
+}
+
+// Full re-merge after the source set or a priority changed. With no live source left the
+// last merged frame is kept so DMX loss handling decides what the outputs do.
+static bool remergeFrame(BufferedUniverseFrame& frame) {
+  bool anyActive = false;
+  frame.topPriority = 0;
+  for (const auto& source : frame.sources) {
+    if (!source.active) continue;
+    if (!anyActive || source.priority > frame.topPriority) {
+      frame.topPriority = source.priority;
+      frame.syncAddress = source.syncAddress;
+    }
+    anyActive = true;
+  }
+  if (!anyActive) return false;
 
-  for (uint8_t i = 0; i < MAX_BUFFERED_UNIVERSES; i++) {
-    bufferedFrames[i] = BufferedUniverseFrame();
+  bool changed = false;
+  for (uint16_t offset = 0; offset < SACN_UNIVERSE_SLOTS; offset += 4) {
+    if (storeMergedWord(frame, offset, mergedWord(frame, offset))) changed = true;
   }
+  return changed;
+}
+
+static SacnSource* findSource(BufferedUniverseFrame& frame, const uint8_t* cid, bool& isNew) {
+  SacnSource* freeSource = nullptr;
+  for (auto& source : frame.sources) {
+    if (source.active && memcmp(source.cid, cid, sizeof(source.cid)) == 0) return &source;
+    if (!source.active && !freeSource) freeSource = &source;
+  }
+  if (!freeSource) return nullptr;
+
+  *freeSource = SacnSource();
+  memcpy(freeSource->cid, cid, sizeof(freeSource->cid));
+  freeSource->active = true;
+  isNew = true;
+  return freeSource;
+}
 
-  if (cfg.sacnMode == SACN_MULTICAST) {
-    e131.begin(E131_MULTICAST, minU, range);
+static bool expireSources(BufferedUniverseFrame& frame, uint32_t nowMs) {
+  bool expired = false;
+  for (auto& source : frame.sources) {
+    if (!source.active || (uint32_t)(nowMs - source.lastSeenMs) < SACN_SOURCE_TIMEOUT_MS) continue;
+    source.active = false;
+    expired = true;
+  }
+  return expired;
+}
+
+static void markAllSlotsChanged(BufferedUniverseFrame& frame) {
+  for (uint8_t w = 0; w < SACN_SLOT_MASK_WORDS; w++) frame.changedSlots[w] = 0xFFFFFFFFUL;
+}
+
+static BufferedUniverseFrame* findBufferedFrame(uint16_t universe) {
+  uint16_t slot = universeLookupHash(universe);
+  for (uint16_t probe = 0; probe < UNIVERSE_LOOKUP_SIZE; probe++) {
+    uint8_t index = universeLookup[slot];
+    if (index == UNIVERSE_LOOKUP_EMPTY) return nullptr;
+    if (bufferedFrames[index].universe == universe) return &bufferedFrames[index];
+    slot = (slot + 1) & (UNIVERSE_LOOKUP_SIZE - 1);
+  }
+  return nullptr;
+}
+
+static void insertUniverseLookup(uint16_t universe, uint8_t index) {
+  uint16_t slot = universeLookupHash(universe);
+  while (universeLookup[slot] != UNIVERSE_LOOKUP_EMPTY) {
+    slot = (slot + 1) & (UNIVERSE_LOOKUP_SIZE - 1);
+  }
+  universeLookup[slot] = index;
+}
+
+static bool universeListed(const uint16_t* universes, uint8_t count, uint16_t universe) {
+  for (uint8_t i = 0; i < count; i++) {
+    if (universes[i] == universe) return true;
+  }
+  return false;
+}
+
+static bool prepareFrameHandoff(uint8_t index);
+
+// Frames keep their table index while their universe stays configured, so merged data,
+// sources and sync holds survive a config change. Entries of dropped universes are freed
+// (universe 0 is never a data universe) and reused for added ones. Kept frames are offered
+// again once with no slot marked changed: subdevices re-initialized by the same edit pick
+// up the current look, carried ones see nothing new.
+static bool updateBufferedFrames(const uint16_t* universes, uint8_t needed) {
+  if (needed > bufferedFrameCapacity) {
+    // Every free entry gets filled before the table grows, so kept frames sit below `needed`.
+    BufferedUniverseFrame* grown = new (std::nothrow) BufferedUniverseFrame[needed];
+    if (!grown) return false;
+    for (uint8_t i = 0; i < bufferedFrameCount; i++) {
+      if (universeListed(universes, needed, bufferedFrames[i].universe)) grown[i] = bufferedFrames[i];
+    }
+    delete[] bufferedFrames;
+    bufferedFrames = grown;
+    bufferedFrameCapacity = needed;
+  }
+
+  for (uint8_t i = 0; i < bufferedFrameCount; i++) {
+    auto& frame = bufferedFrames[i];
+    if (frame.universe == UNIVERSE_FREE) continue;
+    if (universeListed(universes, needed, frame.universe)) {
+      frame.dirty = frame.hasFrame;
+    } else {
+      frame = BufferedUniverseFrame();
+    }
+  }
+
+  uint8_t count = 0;
+  for (uint8_t i = 0; i < bufferedFrameCount; i++) {
+    if (bufferedFrames[i].universe != UNIVERSE_FREE) count = (uint8_t)(i + 1);
+  }
+  memset(universeLookup, UNIVERSE_LOOKUP_EMPTY, sizeof(universeLookup));
+  for (uint8_t i = 0; i < count; i++) {
+    if (bufferedFrames[i].universe != UNIVERSE_FREE) insertUniverseLookup(bufferedFrames[i].universe, i);
+  }
+  bufferedFrameCount = count;
+
+  uint8_t freeIndex = 0;
+  for (uint8_t u = 0; u < needed; u++) {
+    if (findBufferedFrame(universes[u])) continue;
+    while (freeIndex < bufferedFrameCount && bufferedFrames[freeIndex].universe != UNIVERSE_FREE) freeIndex++;
+    if (freeIndex >= bufferedFrameCapacity || !prepareFrameHandoff(freeIndex)) break;
+    bufferedFrames[freeIndex].universe = universes[u];
+    insertUniverseLookup(universes[u], freeIndex);
+    if (freeIndex >= bufferedFrameCount) bufferedFrameCount = (uint8_t)(freeIndex + 1);
+  }
+  return true;
+}
+
+#if SACN_FRAME_HANDOFF
+// Lock-free triple buffer per frame-table slot. The ingest task owns writeIndex and
+// carriedSlots, the runtime task owns readIndex; the middle buffer changes hands only
+// through an atomic exchange on `ready`, so neither side ever waits on the other.
+static constexpr uint8_t HANDOFF_INDEX_MASK = 0x03;
+static constexpr uint8_t HANDOFF_FRESH = 0x04;
+
+struct HandoffBuffer {
+  uint16_t universe = 0;
+  uint32_t changedSlots[SACN_SLOT_MASK_WORDS] = {0};
+  alignas(4) uint8_t slots[SACN_UNIVERSE_SLOTS] = {0};
+};
+
+struct FrameHandoff {
+  HandoffBuffer buffers[3];
+  std::atomic<uint8_t> ready{1};
+  uint8_t writeIndex = 0;
+  uint8_t readIndex = 2;
+  // Changed slots of a published frame the runtime never picked up; folded into the next one.
+  uint32_t carriedSlots[SACN_SLOT_MASK_WORDS] = {0};
+};
+
+// One handoff per frame-table index, allocated the first time the index gets a universe and
+// kept from then on, so the runtime task never sees one move; only configured universes cost
+// handoff memory.
+static std::atomic<FrameHandoff*> frameHandoffs[MAX_UNIVERSES];
+// Set when an ingest pass published frames; the runtime is woken once at the end of the
+// pass so all universes of a synchronized look are picked up together.
+static bool framesPublished = false;
+
+// A reused frame entry starts a new universe; changes carried for the old one are dropped.
+static bool prepareFrameHandoff(uint8_t index) {
+  FrameHandoff* handoff = frameHandoffs[index].load(std::memory_order_relaxed);
+  if (handoff) {
+    memset(handoff->carriedSlots, 0, sizeof(handoff->carriedSlots));
+    return true;
+  }
+  handoff = new (std::nothrow) FrameHandoff();
+  if (!handoff) return false;
+  frameHandoffs[index].store(handoff, std::memory_order_release);
+  return true;
+}
+
+static void publishFrame(FrameHandoff& handoff, const BufferedUniverseFrame& frame) {
+  HandoffBuffer& back = handoff.buffers[handoff.writeIndex];
+  back.universe = frame.universe;
+  memcpy(back.slots, frame.slots, sizeof(back.slots));
+  for (uint8_t w = 0; w < SACN_SLOT_MASK_WORDS; w++) {
+    back.changedSlots[w] = frame.changedSlots[w] | handoff.carriedSlots[w];
+  }
+
+  uint8_t previous = handoff.ready.exchange((uint8_t)(handoff.writeIndex | HANDOFF_FRESH), std::memory_order_acq_rel);
+  handoff.writeIndex = previous & HANDOFF_INDEX_MASK;
+  if ((previous & HANDOFF_FRESH) != 0) {
+    memcpy(handoff.carriedSlots, handoff.buffers[handoff.writeIndex].changedSlots, sizeof(handoff.carriedSlots));
   } else {
-    e131.begin(E131_UNICAST, minU, range);
+    memset(handoff.carriedSlots, 0, sizeof(handoff.carriedSlots));
   }
-  e131Started = true;
+  framesPublished = true;
 }
+#else
+static bool prepareFrameHandoff(uint8_t) { return true; }
+#endif
+
+static void applyBufferedFrame(BufferedUniverseFrame& frame, uint32_t nowMs) {
+#if SACN_FRAME_HANDOFF
+  publishFrame(*frameHandoffs[&frame - bufferedFrames].load(std::memory_order_relaxed), frame);
+#else
+  applySacnToSubdevices(frame.universe, frame.slots, SACN_UNIVERSE_SLOTS, frame.changedSlots);
+#endif
+  memset(frame.changedSlots, 0, sizeof(frame.changedSlots));
+  frame.lastApplyMs = nowMs;
+  frame.dirty = false;
+}
+
+static SyncAddressState* findSyncAddress(uint16_t syncAddress) {
+  for (auto& entry : syncAddresses) {
+    if (entry.address != 0 && entry.address == syncAddress) return &entry;
+  }
+  return nullptr;
+}
+
+static bool syncActive(uint16_t syncAddress, uint32_t nowMs) {
+  const SyncAddressState* entry = findSyncAddress(syncAddress);
+  return entry && entry->seen && (uint32_t)(nowMs - entry->lastSyncMs) < SACN_SYNC_LOSS_MS;
+}
+
+static void publishSyncAddresses() {
+  uint16_t addresses[E131_MAX_SYNC_UNIVERSES];
+  uint8_t count = 0;
+  for (const auto& entry : syncAddresses) {
+    if (entry.address != 0) addresses[count++] = entry.address;
+  }
+  e131ReceiverSetSyncUniverses(cfg.sacnMode, addresses, count);
+}
+
+// Frames tagged with an address that finds no free or stale entry are not held.
+static void trackSyncAddress(uint16_t syncAddress, uint32_t nowMs) {
+  SyncAddressState* entry = findSyncAddress(syncAddress);
+  if (!entry) {
+    for (auto& candidate : syncAddresses) {
+      if (candidate.address == 0 || (uint32_t)(nowMs - candidate.lastTaggedMs) >= SACN_SYNC_LOSS_MS) {
+        entry = &candidate;
+        break;
+      }
+    }
+    if (!entry) return;
+    *entry = SyncAddressState();
+    entry->address = syncAddress;
+    publishSyncAddresses();
+  }
+  entry->lastTaggedMs = nowMs;
+}
+
+// Commits every frame held for this sync address back-to-back, so all universes of a
+// synchronized look reach the subdevices in the same pass.
+static void commitSyncedFrames(uint16_t syncAddress, uint32_t nowMs) {
+  SyncAddressState* entry = findSyncAddress(syncAddress);
+  if (!entry) return;
+  entry->seen = true;
+  entry->lastSyncMs = nowMs;
+
+  for (uint8_t i = 0; i < bufferedFrameCount; i++) {
+    auto& frame = bufferedFrames[i];
+    if (!frame.syncHeld || frame.syncAddress != syncAddress) continue;
+    frame.syncHeld = false;
+    if (frame.hasFrame && frame.dirty) applyBufferedFrame(frame, nowMs);
+  }
+}
+
+// Reads the newest published subdevice snapshot, so this runs on the publishing side.
+static uint8_t collectSubdeviceUniverses(uint16_t* universes) {
+  uint8_t count = subdeviceUniverseCount();
+  for (uint8_t i = 0; i < count; i++) universes[i] = subdeviceUniverseAt(i);
+  return count;
+}
+
+static void resetSyncTracking() {
+  for (auto& entry : syncAddresses) entry = SyncAddressState();
+}
+
+static void beginSacn(const uint16_t* universes, uint8_t count) {
+  e131Started = false;
+  resetSyncTracking();
+  sacnModeInUse = cfg.sacnMode;
+  if (!updateBufferedFrames(universes, count)) return;
+
+  e131Started = e131ReceiverBegin(cfg.sacnMode, universes, count);
+#if USE_ARTNET
+  artnetReceiverBegin(cfg.artnetUniverseOffset, universes, count);
+#endif
+}
+
+void startSacn() {
+  uint16_t universes[MAX_UNIVERSES];
+  uint8_t count = collectSubdeviceUniverses(universes);
+  beginSacn(universes, count);
+}
+
+// Config changes keep the receiver socket open and only adjust multicast membership for
+// universes that were added or dropped; frames of unchanged universes are kept.
+static void reconfigureSacn(const uint16_t* universes, uint8_t count) {
+  if (!e131Started) {
+    beginSacn(universes, count);
+    return;
+  }
+  if (!updateBufferedFrames(universes, count)) return;
+
+  e131ReceiverSetUniverses(cfg.sacnMode, universes, count);
+#if USE_ARTNET
+  artnetReceiverSetUniverses(cfg.artnetUniverseOffset, universes, count);
+#endif
+  if (cfg.sacnMode != sacnModeInUse) {
+    // The sync group membership follows the mode; it is re-joined from the next tagged packet.
+    sacnModeInUse = cfg.sacnMode;
+    resetSyncTracking();
+    publishSyncAddresses();
+  }
+}
+
+#if SACN_FRAME_HANDOFF
+// Universe list handed from the web side to the ingest task, which owns the frame table.
+// Whoever exchanges a plan out of pendingPlan owns (and frees) it.
+struct SacnUniversePlan {
+  uint8_t count = 0;
+  uint16_t universes[MAX_UNIVERSES];
+};
+
+static std::atomic<SacnUniversePlan*> pendingPlan(nullptr);
+#endif
 
 void restartSacn() {
-  startSacn();
+#if SACN_FRAME_HANDOFF
+  SacnUniversePlan* plan = new (std::nothrow) SacnUniversePlan();
+  if (!plan) return;
+  plan->count = collectSubdeviceUniverses(plan->universes);
+  delete pendingPlan.exchange(plan, std::memory_order_acq_rel);
+#else
+  uint16_t universes[MAX_UNIVERSES];
+  uint8_t count = collectSubdeviceUniverses(universes);
+  reconfigureSacn(universes, count);
+#endif
 }
 
-void handleSacnPackets() {
-  if (!e131Started) return;
+// Single ingest path for every protocol: source tracking, merge, dirty-slot marking and
+// sync holds are identical for E1.31 and Art-Net packets.
+static void ingestDataPacket(const DmxPacketView& p) {
+  uint16_t u = p.universe;
+  lastUniverseSeenValue = u;
+  sacnPacketCount++;
 
-  while (!e131.isEmpty()) {
-    e131_packet_t p;
-    e131.pull(&p);
+  if (p.startCode != 0x00) return;
 
-    uint16_t u = ntohs(p.universe);
-    lastUniverseSeenValue = u;
-    sacnPacketCount++;
+  const bool isPreview = (p.options & E131_OPT_PREVIEW) != 0;
+  if (isPreview) return;
 
-    const uint8_t startCode = p.property_values[0];
-    if (startCode != 0x00) continue;
+  // Universes no subdevice is mapped to are dropped without touching the frame table.
+  BufferedUniverseFrame* frame = findBufferedFrame(u);
+  if (!frame) return;
 
-    const bool isPreview = (p.options & 0x80) != 0;
-    if (isPreview) continue;
+  uint32_t nowMs = millis();
+  bool newSource = false;
+  SacnSource* source = findSource(*frame, p.cid, newSource);
+  if (!source) return;
 
-    uint32_t nowMs = millis();
-    BufferedUniverseFrame* frame = findBufferedFrame(u, true, nowMs);
-    if (!frame) continue;
+  if ((p.options & E131_OPT_TERMINATED) != 0) {
+    source->active = false;
+    if (remergeFrame(*frame)) frame->dirty = true;
+    return;
+  }
 
-    const uint8_t seq = p.sequence_number;
-    if (frame->seqValid) {
-      const uint8_t diff = (uint8_t)(seq - frame->lastSeq);
-      if (diff == 0) continue;
-      if (diff > 200) continue;
+  if (!newSource && p.sequenced) {
+    const uint8_t diff = (uint8_t)(p.sequence - source->lastSeq);
+    if (diff == 0) return;
+    if (diff > 200) return;
+  }
+  source->lastSeq = p.sequence;
+  source->lastSeenMs = nowMs;
+
+  // Only words this source changed are re-merged, unless the source set or a
+  // priority changed, which needs a full pass.
+  uint32_t changedWords[SACN_WORD_MASK_WORDS] = {0};
+  bool sourceChanged = copyIncomingSlots(*source, p.slots, p.slotCount, changedWords);
+  bool changed = false;
+  if (newSource || source->priority != p.priority || !frame->hasFrame) {
+    source->priority = p.priority;
+    changed = remergeFrame(*frame);
+  } else if (sourceChanged && source->priority == frame->topPriority) {
+    changed = mergeChangedWords(*frame, changedWords);
+  }
+  if (!frame->hasFrame) {
+    markAllSlotsChanged(*frame);
+    changed = true;
+  }
+  if (changed) {
+    frame->dirty = true;
+  }
+  frame->hasFrame = true;
+  frame->lastSeenMs = nowMs;
+
+  source->syncAddress = p.syncAddress;
+  if (source->priority == frame->topPriority) {
+    frame->syncAddress = p.syncAddress;
+    if (p.syncAddress != 0) {
+      trackSyncAddress(p.syncAddress, nowMs);
+      if (frame->dirty && !frame->syncHeld && syncActive(p.syncAddress, nowMs)) {
+        frame->syncHeld = true;
+        frame->syncHeldSinceMs = nowMs;
+      }
+    } else {
+      frame->syncHeld = false;
     }
-    frame->lastSeq = seq;
-    frame->seqValid = true;
+  }
 
-    const uint8_t* incoming = &p.property_values[1];
-    bool changed = memcmp(frame->slots, incoming, sizeof(frame->slots)) != 0;
-    if (changed) {
-      memcpy(frame->slots, incoming, sizeof(frame->slots));
-    }
-    if (!frame->hasFrame || changed) {
-      frame->dirty = true;
+  haveDmx = true;
+  lastDmxMs = nowMs;
+}
+
+void handleSacnPackets() {
+#if SACN_FRAME_HANDOFF
+  if (pendingPlan.load(std::memory_order_acquire)) {
+    SacnUniversePlan* plan = pendingPlan.exchange(nullptr, std::memory_order_acq_rel);
+    if (plan) reconfigureSacn(plan->universes, plan->count);
+    delete plan;
+  }
+#endif
+  if (!e131Started) return;
+
+  DmxPacketView p;
+  E131SyncView sync;
+  for (uint8_t n = 0; n < SACN_MAX_PACKETS_PER_POLL; n++) {
+    E131PollResult result = e131ReceiverPoll(p, sync);
+    if (result == E131_POLL_EMPTY) break;
+    if (result == E131_POLL_SYNC) {
+      commitSyncedFrames(sync.syncAddress, millis());
+      continue;
     }
-    frame->hasFrame = true;
-    frame->lastSeenMs = nowMs;
+    if (result == E131_POLL_DATA) ingestDataPacket(p);
+  }
 
-    haveDmx = true;
-    lastDmxMs = nowMs;
+#if USE_ARTNET
+  for (uint8_t n = 0; n < SACN_MAX_PACKETS_PER_POLL; n++) {
+    ArtnetPollResult result = artnetReceiverPoll(p);
+    if (result == ARTNET_POLL_EMPTY) break;
+    if (result == ARTNET_POLL_DATA) ingestDataPacket(p);
   }
+#endif
 
   const uint32_t now = millis();
-  for (uint8_t i = 0; i < MAX_BUFFERED_UNIVERSES; i++) {
+  for (uint8_t i = 0; i < bufferedFrameCount; i++) {
     auto& frame = bufferedFrames[i];
-    if (frame.universe == 0 || !frame.hasFrame || !frame.dirty) continue;
+    if (frame.hasFrame && expireSources(frame, now) && remergeFrame(frame)) {
+      frame.dirty = true;
+    }
+    if (!frame.hasFrame || !frame.dirty) continue;
 
-    if (cfg.sacnBufferMs != 0) {
+    if (frame.syncHeld) {
+      if ((uint32_t)(now - frame.syncHeldSinceMs) < SACN_SYNC_TIMEOUT_MS) continue;
+      frame.syncHeld = false;
+    } else if (cfg.sacnBufferMs != 0) {
       if (frame.lastApplyMs != 0 && (uint32_t)(now - frame.lastApplyMs) < cfg.sacnBufferMs) continue;
     }
 
-    applySacnToSubdevices(frame.universe, frame.slots, 512);
-    frame.lastApplyMs = now;
-    frame.dirty = false;
+    applyBufferedFrame(frame, now);
+  }
+#if SACN_FRAME_HANDOFF
+  if (framesPublished) {
+    framesPublished = false;
+    runtimeWakeNotify();
+  }
+#endif
+}
+
+void sacnIngestDeadline(RuntimeDeadline& deadline) {
+#if SACN_FRAME_HANDOFF
+  if (pendingPlan.load(std::memory_order_acquire)) deadlineIn(deadline, 0);
+#endif
+  for (uint8_t i = 0; i < bufferedFrameCount; i++) {
+    const auto& frame = bufferedFrames[i];
+    if (!frame.hasFrame) continue;
+    for (const auto& source : frame.sources) {
+      if (source.active) deadlineAt(deadline, source.lastSeenMs + SACN_SOURCE_TIMEOUT_MS);
+    }
+    if (!frame.dirty) continue;
+    if (frame.syncHeld) {
+      deadlineAt(deadline, frame.syncHeldSinceMs + SACN_SYNC_TIMEOUT_MS);
+    } else if (cfg.sacnBufferMs != 0 && frame.lastApplyMs != 0) {
+      deadlineAt(deadline, frame.lastApplyMs + cfg.sacnBufferMs);
+    } else {
+      deadlineIn(deadline, 0);
+    }
+  }
+}
+
+void sacnWaitForPackets(uint32_t timeoutMs) {
+  UdpEndpoint* endpoints[] = {
+    e131ReceiverEndpoint(),
+#if USE_ARTNET
+    artnetReceiverEndpoint(),
+#endif
+  };
+  udpWaitReadable(endpoints, (uint8_t)(sizeof(endpoints) / sizeof(endpoints[0])), timeoutMs);
+}
+
+// Runtime side of the handoff: applies the newest frame published for each universe.
+void applySacnFrames() {
+#if SACN_FRAME_HANDOFF
+  for (uint8_t i = 0; i < MAX_UNIVERSES; i++) {
+    FrameHandoff* entry = frameHandoffs[i].load(std::memory_order_acquire);
+    if (!entry) continue;
+    FrameHandoff& handoff = *entry;
+    if ((handoff.ready.load(std::memory_order_acquire) & HANDOFF_FRESH) == 0) continue;
+    uint8_t previous = handoff.ready.exchange(handoff.readIndex, std::memory_order_acq_rel);
+    handoff.readIndex = previous & HANDOFF_INDEX_MASK;
+    const HandoffBuffer& front = handoff.buffers[handoff.readIndex];
+    applySacnToSubdevices(front.universe, front.slots, SACN_UNIVERSE_SLOTS, front.changedSlots);
   }
+#endif
 }
 
 void enforceDmxLoss() {
@@ -163,6 +704,10 @@ void enforceDmxLoss() {
   stopSubdevicesOnLoss();
 }
 
+void dmxLossDeadline(RuntimeDeadline& deadline) {
+  if (haveDmx) deadlineAt(deadline, lastDmxMs + cfg.lossTimeoutMs);
+}
+
 uint32_t sacnPacketCounter() { return sacnPacketCount; }
 uint16_t lastUniverseSeen() { return lastUniverseSeenValue; }
 uint16_t lastDcRawValue() { return 0; }
@@ -174,7 +719,11 @@ bool dmxActive() { return haveDmx; }
 void startSacn() {}
 void restartSacn() {}
 void handleSacnPackets() {}
+void applySacnFrames() {}
 void enforceDmxLoss() {}
+void sacnIngestDeadline(RuntimeDeadline&) {}
+void dmxLossDeadline(RuntimeDeadline&) {}
+void sacnWaitForPackets(uint32_t timeoutMs) { delay(timeoutMs); }
 uint32_t sacnPacketCounter() { return 0; }
 uint16_t lastUniverseSeen() { return 0; }
 uint16_t lastDcRawValue() { return 0; }
@@ -0,0 +1,206 @@
+#include "platform/esp32/e131_receiver.h"
+
+#include "core/features.h"
+
+#if USE_SACN
+
+#include <string.h>
+
+#include "platform/esp32/udp_transport.h"
+
+static constexpr uint32_t E131_ROOT_VECTOR_DATA = 0x00000004UL;
+static constexpr uint32_t E131_ROOT_VECTOR_EXTENDED = 0x00000008UL;
+static constexpr uint32_t E131_FRAMING_VECTOR_DATA = 0x00000002UL;
+static constexpr uint32_t E131_FRAMING_VECTOR_SYNC = 0x00000001UL;
+static constexpr uint8_t E131_DMP_VECTOR_SET_PROPERTY = 0x02;
+static constexpr uint8_t E131_DMP_ADDRESS_DATA_TYPE = 0xA1;
+static constexpr uint16_t E131_DATA_HEADER_SIZE = 126;
+static constexpr uint16_t E131_SYNC_PACKET_SIZE = 49;
+
+static const uint8_t E131_ACN_ID[12] = {'A', 'S', 'C', '-', 'E', '1', '.', '1', '7', 0, 0, 0};
+
+// Packet buffer shared by every poll; the parsed view points straight into it.
+alignas(4) static uint8_t packetBuffer[E131_MAX_PACKET_SIZE];
+static UdpEndpoint receiverEndpoint;
+
+// Data universes and sync addresses the receiver listens for, and the multicast groups
+// joined for them; changes to either list only join/leave the difference.
+static SacnMode membershipMode = SACN_UNICAST;
+static uint16_t dataUniverses[MAX_UNIVERSES];
+static uint8_t dataUniverseCount = 0;
+static uint16_t syncUniverses[E131_MAX_SYNC_UNIVERSES];
+static uint8_t syncUniverseCount = 0;
+static uint16_t joinedGroups[MAX_UNIVERSES + E131_MAX_SYNC_UNIVERSES];
+static uint8_t joinedGroupCount = 0;
+
+static uint16_t readBe16(const uint8_t* p) {
+  return (uint16_t)(((uint16_t)p[0] << 8) | p[1]);
+}
+
+static uint32_t readBe32(const uint8_t* p) {
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+// PDU flags live in the top nibble of each layer's flags+length word and must be 0x7.
+static bool pduFlagsValid(const uint8_t* p) {
+  return (p[0] & 0xF0) == 0x70;
+}
+
+static bool rootLayerValid(const uint8_t* data, uint32_t vector) {
+  if (readBe16(&data[0]) != 0x0010 || readBe16(&data[2]) != 0x0000) return false;
+  if (memcmp(&data[4], E131_ACN_ID, sizeof(E131_ACN_ID)) != 0) return false;
+  return pduFlagsValid(&data[16]) && readBe32(&data[18]) == vector;
+}
+
+bool e131ParseDataPacket(const uint8_t* data, size_t len, DmxPacketView& out) {
+  if (!data || len < E131_DATA_HEADER_SIZE) return false;
+
+  // Root layer
+  if (!rootLayerValid(data, E131_ROOT_VECTOR_DATA)) return false;
+
+  // Framing layer
+  if (!pduFlagsValid(&data[38]) || readBe32(&data[40]) != E131_FRAMING_VECTOR_DATA) return false;
+
+  // DMP layer
+  if (!pduFlagsValid(&data[115])) return false;
+  if (data[117] != E131_DMP_VECTOR_SET_PROPERTY || data[118] != E131_DMP_ADDRESS_DATA_TYPE) return false;
+  if (readBe16(&data[119]) != 0x0000 || readBe16(&data[121]) != 0x0001) return false;
+
+  uint16_t propertyCount = readBe16(&data[123]);
+  if (propertyCount < 1 || propertyCount > 513) return false;
+  if ((size_t)(E131_DATA_HEADER_SIZE - 1) + propertyCount > len) return false;
+
+  uint16_t universe = readBe16(&data[113]);
+  if (universe < 1 || universe > 63999) return false;
+
+  out.cid = &data[22];
+  out.priority = data[108];
+  out.syncAddress = readBe16(&data[109]);
+  out.sequence = data[111];
+  out.options = data[112];
+  out.universe = universe;
+  out.startCode = data[125];
+  out.slots = &data[E131_DATA_HEADER_SIZE];
+  out.slotCount = (uint16_t)(propertyCount - 1);
+  return true;
+}
+
+bool e131ParseSyncPacket(const uint8_t* data, size_t len, E131SyncView& out) {
+  if (!data || len < E131_SYNC_PACKET_SIZE) return false;
+  if (!rootLayerValid(data, E131_ROOT_VECTOR_EXTENDED)) return false;
+  if (!pduFlagsValid(&data[38]) || readBe32(&data[40]) != E131_FRAMING_VECTOR_SYNC) return false;
+
+  uint16_t syncAddress = readBe16(&data[45]);
+  if (syncAddress < 1 || syncAddress > 63999) return false;
+
+  out.cid = &data[22];
+  out.sequence = data[44];
+  out.syncAddress = syncAddress;
+  return true;
+}
+
+static uint32_t universeGroup(uint16_t universe) {
+  return 0xEFFF0000UL | universe;
+}
+
+static bool transportJoin(uint16_t universe) {
+  return udpJoinGroup(receiverEndpoint, universeGroup(universe));
+}
+
+static void transportLeave(uint16_t universe) {
+  udpLeaveGroup(receiverEndpoint, universeGroup(universe));
+}
+
+static bool containsUniverse(const uint16_t* universes, uint8_t count, uint16_t universe) {
+  for (uint8_t i = 0; i < count; i++) {
+    if (universes[i] == universe) return true;
+  }
+  return false;
+}
+
+// A sync address can also be a data universe; its group is joined once for both.
+static bool groupWanted(uint16_t universe) {
+  if (membershipMode != SACN_MULTICAST) return false;
+  return containsUniverse(dataUniverses, dataUniverseCount, universe) ||
+         containsUniverse(syncUniverses, syncUniverseCount, universe);
+}
+
+static void joinMissing(const uint16_t* universes, uint8_t count) {
+  for (uint8_t i = 0; i < count; i++) {
+    if (containsUniverse(joinedGroups, joinedGroupCount, universes[i])) continue;
+    if (transportJoin(universes[i])) joinedGroups[joinedGroupCount++] = universes[i];
+  }
+}
+
+static void updateMembership() {
+  uint8_t kept = 0;
+  for (uint8_t i = 0; i < joinedGroupCount; i++) {
+    if (groupWanted(joinedGroups[i])) {
+      joinedGroups[kept++] = joinedGroups[i];
+    } else {
+      transportLeave(joinedGroups[i]);
+    }
+  }
+  joinedGroupCount = kept;
+  if (membershipMode != SACN_MULTICAST) return;
+  joinMissing(dataUniverses, dataUniverseCount);
+  joinMissing(syncUniverses, syncUniverseCount);
+}
+
+bool e131ReceiverBegin(SacnMode mode, const uint16_t* universes, uint8_t universeCount) {
+  e131ReceiverStop();
+  if (!udpOpen(receiverEndpoint, E131_PORT)) return false;
+  e131ReceiverSetUniverses(mode, universes, universeCount);
+  return true;
+}
+
+void e131ReceiverSetUniverses(SacnMode mode, const uint16_t* universes, uint8_t universeCount) {
+  if (!receiverEndpoint.open) return;
+  membershipMode = mode;
+  dataUniverseCount = universeCount < MAX_UNIVERSES ? universeCount : MAX_UNIVERSES;
+  memcpy(dataUniverses, universes, dataUniverseCount * sizeof(dataUniverses[0]));
+  updateMembership();
+}
+
+void e131ReceiverSetSyncUniverses(SacnMode mode, const uint16_t* syncAddresses, uint8_t count) {
+  if (!receiverEndpoint.open) return;
+  membershipMode = mode;
+  syncUniverseCount = count < E131_MAX_SYNC_UNIVERSES ? count : E131_MAX_SYNC_UNIVERSES;
+  memcpy(syncUniverses, syncAddresses, syncUniverseCount * sizeof(syncUniverses[0]));
+  updateMembership();
+}
+
+void e131ReceiverStop() {
+  if (!receiverEndpoint.open) return;
+  for (uint8_t i = 0; i < joinedGroupCount; i++) transportLeave(joinedGroups[i]);
+  joinedGroupCount = 0;
+  dataUniverseCount = 0;
+  syncUniverseCount = 0;
+  udpClose(receiverEndpoint);
+}
+
+E131PollResult e131ReceiverPoll(DmxPacketView& data, E131SyncView& sync) {
+  if (!receiverEndpoint.open) return E131_POLL_EMPTY;
+  int len = udpReceive(receiverEndpoint, packetBuffer, sizeof(packetBuffer), nullptr);
+  if (len <= 0) return E131_POLL_EMPTY;
+  if (len >= 22 && readBe32(&packetBuffer[18]) == E131_ROOT_VECTOR_EXTENDED) {
+    return e131ParseSyncPacket(packetBuffer, (size_t)len, sync) ? E131_POLL_SYNC : E131_POLL_IGNORED;
+  }
+  if (!e131ParseDataPacket(packetBuffer, (size_t)len, data)) return E131_POLL_IGNORED;
+  return E131_POLL_DATA;
+}
+
+UdpEndpoint* e131ReceiverEndpoint() { return &receiverEndpoint; }
+
+#else
+
+bool e131ParseDataPacket(const uint8_t*, size_t, DmxPacketView&) { return false; }
+bool e131ParseSyncPacket(const uint8_t*, size_t, E131SyncView&) { return false; }
+bool e131ReceiverBegin(SacnMode, const uint16_t*, uint8_t) { return false; }
+void e131ReceiverSetUniverses(SacnMode, const uint16_t*, uint8_t) {}
+void e131ReceiverSetSyncUniverses(SacnMode, const uint16_t*, uint8_t) {}
+void e131ReceiverStop() {}
+E131PollResult e131ReceiverPoll(DmxPacketView&, E131SyncView&) { return E131_POLL_EMPTY; }
+UdpEndpoint* e131ReceiverEndpoint() { return nullptr; }
+
+#endif
@@ -0,0 +1,39 @@
+#include "platform/gpio_batch.h"
+
+#if defined(ESP32)
+
+#include "soc/gpio_struct.h"
+
+void GPIO_BATCH_ISR_ATTR gpioBatchCommit(GpioBatch& batch) {
+  // Clear first so outputs switching off never overlap the ones switching on.
+  if (batch.clearMask[0]) GPIO.out_w1tc = batch.clearMask[0];
+  if (batch.setMask[0]) GPIO.out_w1ts = batch.setMask[0];
+#if SOC_GPIO_PIN_COUNT > 32
+  if (batch.clearMask[1]) GPIO.out1_w1tc.val = batch.clearMask[1];
+  if (batch.setMask[1]) GPIO.out1_w1ts.val = batch.setMask[1];
+#endif
+  for (uint8_t bank = 0; bank < GPIO_BATCH_BANKS; bank++) {
+    batch.setMask[bank] = 0;
+    batch.clearMask[bank] = 0;
+  }
+}
+
+#elif defined(ESP8266)
+
+// GPIO16 sits outside the GPOS/GPOC bank and has its own output register.
+static constexpr uint32_t GPIO_BATCH_GPIO16_BIT = 1u << 16;
+
+void GPIO_BATCH_ISR_ATTR gpioBatchCommit(GpioBatch& batch) {
+  const uint32_t clearMask = batch.clearMask[0];
+  const uint32_t setMask = batch.setMask[0];
+  if (clearMask & 0xFFFF) GPOC = clearMask & 0xFFFF;
+  if (setMask & 0xFFFF) GPOS = setMask & 0xFFFF;
+  if (clearMask & GPIO_BATCH_GPIO16_BIT) GP16O &= ~1u;
+  if (setMask & GPIO_BATCH_GPIO16_BIT) GP16O |= 1u;
+  for (uint8_t bank = 0; bank < GPIO_BATCH_BANKS; bank++) {
+    batch.setMask[bank] = 0;
+    batch.clearMask[bank] = 0;
+  }
+}
+
+#endif
@@ -0,0 +1,669 @@
+#include "platform/pixel_output.h"
+
+#include "core/features.h"
+
+#if USE_PIXELS && (defined(ESP32) || defined(ESP8266))
+
+#include <Arduino.h>
+#include <new>
+
+#if defined(ESP32) && CONFIG_IDF_TARGET_ESP32
+#define PIXEL_OUTPUT_DMA 1
+#include "driver/periph_ctrl.h"
+#include "driver/rmt.h"
+#include "esp32/rom/lldesc.h"
+#include "esp_heap_caps.h"
+#include "soc/gpio_sig_map.h"
+#include "soc/i2s_struct.h"
+#else
+#define PIXEL_OUTPUT_DMA 0
+#include <Adafruit_NeoPixel.h>
+#endif
+
+struct PixelOutput {
+  uint8_t* back = nullptr;
+  uint16_t count = 0;
+  uint8_t pin = 0;
+  bool attached = false;
+  bool pending = false;
+#if PIXEL_OUTPUT_DMA
+  // RMT outputs only: frame on the wire; the translator reads it until the send is over.
+  uint8_t* front = nullptr;
+  uint32_t startUs = 0;
+  bool sending = false;
+#endif
+};
+
+static size_t frameBytes(const PixelOutput& out) {
+  return (size_t)out.count * PIXEL_OUTPUT_BYTES_PER_PIXEL;
+}
+
+// Frame buffer bytes in use, their high-water mark and strips refused since boot.
+struct PixelFrameUsage {
+  uint32_t used = 0;
+  uint32_t peak = 0;
+  uint16_t refused = 0;
+};
+
+static PixelFrameUsage frameUsage;
+
+static void frameUsageAdd(size_t bytes) {
+  frameUsage.used += bytes;
+  if (frameUsage.used > frameUsage.peak) frameUsage.peak = frameUsage.used;
+}
+
+static void frameUsageRemove(size_t bytes) {
+  frameUsage.used -= bytes;
+}
+
+#if PIXEL_OUTPUT_DMA
+
+// Outputs 0..7 are the lanes of the I2S parallel group, 8..11 RMT channels 0..3 (STEP/DIR
+// pulses own channels 4..7). Strips take lanes first: one DMA transfer clocks all of them
+// at once, where every RMT channel needs a refill interrupt per 8 pixels. RMT only gets a
+// strip when the group has no lane (or DMA memory) left for it.
+static constexpr uint8_t PIXEL_I2S_LANES = 8;
+static constexpr uint8_t PIXEL_RMT_CHANNELS = 4;
+static constexpr uint8_t PIXEL_OUTPUT_COUNT = PIXEL_I2S_LANES + PIXEL_RMT_CHANNELS;
+// 24 bits of 1.25 us per pixel, then the latch gap (WS2812B wants 280 us low).
+static constexpr uint32_t PIXEL_US_PER_PIXEL = 30;
+static constexpr uint32_t PIXEL_LATCH_US = 300;
+// Longest frame (1024 pixels) plus margin.
+static constexpr uint32_t PIXEL_DETACH_WAIT_MS = 50;
+
+static PixelOutput pixelOutputs[PIXEL_OUTPUT_COUNT];
+
+static rmt_channel_t rmtChannel(uint8_t output) {
+  return (rmt_channel_t)(output - PIXEL_I2S_LANES);
+}
+
+static bool frameTimeElapsed(uint32_t startUs, uint16_t pixels) {
+  return micros() - startUs >= pixels * PIXEL_US_PER_PIXEL + PIXEL_LATCH_US;
+}
+
+// I2S1 in LCD mode shifts out one byte per sample at 2.4 MHz, bit l on lane l's pin. A
+// WS2812 bit is three samples of 0.42 us (high, data, low), so every byte of the frame
+// becomes 24 samples covering all lanes. The group shares one DMA frame, reserved at boot
+// for the longest configured strip; a lane longer than that goes to RMT instead. The high
+// sample goes to every attached lane, so a shorter lane keeps clocking out zero bits until
+// the longest one is done; its strip passes them on past its last pixel, where nothing reads
+// them.
+static constexpr uint8_t PIXEL_I2S_SAMPLES_PER_BYTE = 24;
+// A descriptor carries at most 4095 bytes; keep each one word-aligned.
+static constexpr uint16_t PIXEL_I2S_DESCRIPTOR_BYTES = 4092;
+// Low samples after the frame, so the lines rest low while the FIFO drains.
+static constexpr uint16_t PIXEL_I2S_TAIL_BYTES = 32;
+
+struct PixelI2sGroup {
+  uint8_t* samples = nullptr;
+  lldesc_t* descriptors = nullptr;
+  // Longest lane the reserved frame holds, the one currently sent and its high-water mark.
+  uint16_t capacity = 0;
+  uint16_t pixels = 0;
+  uint16_t peakPixels = 0;
+  uint8_t laneMask = 0;
+  bool configured = false;
+  bool sending = false;
+  uint32_t startUs = 0;
+};
+
+static PixelI2sGroup i2sGroup;
+
+static size_t i2sFrameBytes(uint16_t pixels) {
+  return (size_t)pixels * PIXEL_OUTPUT_BYTES_PER_PIXEL * PIXEL_I2S_SAMPLES_PER_BYTE + PIXEL_I2S_TAIL_BYTES;
+}
+
+static void i2sConfigure() {
+  periph_module_enable(PERIPH_I2S1_MODULE);
+  I2S1.conf.val = 0;
+  I2S1.conf1.val = 0;
+  I2S1.conf1.tx_pcm_bypass = 1;
+  I2S1.conf2.val = 0;
+  I2S1.conf2.lcd_en = 1;
+  I2S1.conf_chan.val = 0;
+  I2S1.conf_chan.tx_chan_mod = 1;
+  I2S1.fifo_conf.val = 0;
+  I2S1.fifo_conf.tx_fifo_mod_force_en = 1;
+  I2S1.fifo_conf.tx_fifo_mod = 1;
+  I2S1.fifo_conf.tx_data_num = 32;
+  I2S1.fifo_conf.dscr_en = 1;
+  // 160 MHz / (33 + 1/3) = 4.8 MHz, halved again by the bit clock: 2.4 MHz samples.
+  I2S1.clkm_conf.val = 0;
+  I2S1.clkm_conf.clkm_div_num = 33;
+  I2S1.clkm_conf.clkm_div_b = 1;
+  I2S1.clkm_conf.clkm_div_a = 3;
+  I2S1.clkm_conf.clk_en = 1;
+  I2S1.sample_rate_conf.val = 0;
+  I2S1.sample_rate_conf.tx_bits_mod = 8;
+  I2S1.sample_rate_conf.tx_bck_div_num = 2;
+  I2S1.timing.val = 0;
+  I2S1.int_ena.val = 0;
+  I2S1.lc_conf.val = 0;
+  I2S1.lc_conf.out_eof_mode = 1;
+  I2S1.lc_conf.outdscr_burst_en = 1;
+  I2S1.lc_conf.out_data_burst_en = 1;
+  i2sGroup.configured = true;
+}
+
+static bool i2sIdle() {
+  if (!i2sGroup.sending) return true;
+  if (!frameTimeElapsed(i2sGroup.startUs, i2sGroup.pixels) || !I2S1.int_raw.out_total_eof) return false;
+  I2S1.conf.tx_start = 0;
+  i2sGroup.sending = false;
+  return true;
+}
+
+static void i2sWaitIdle() {
+  uint32_t start = millis();
+  while (!i2sIdle() && millis() - start < PIXEL_DETACH_WAIT_MS) delay(1);
+}
+
+static bool i2sReserve(uint16_t pixels) {
+  const size_t bytes = i2sFrameBytes(pixels);
+  const size_t count = (bytes + PIXEL_I2S_DESCRIPTOR_BYTES - 1) / PIXEL_I2S_DESCRIPTOR_BYTES;
+  i2sGroup.samples = static_cast<uint8_t*>(heap_caps_malloc(bytes, MALLOC_CAP_DMA));
+  i2sGroup.descriptors = static_cast<lldesc_t*>(heap_caps_malloc(count * sizeof(lldesc_t), MALLOC_CAP_DMA));
+  if (!i2sGroup.samples || !i2sGroup.descriptors) {
+    heap_caps_free(i2sGroup.samples);
+    heap_caps_free(i2sGroup.descriptors);
+    i2sGroup.samples = nullptr;
+    i2sGroup.descriptors = nullptr;
+    return false;
+  }
+  i2sGroup.capacity = pixels;
+  return true;
+}
+
+// Chains the descriptors over the first `pixels` per lane of the reserved frame and
+// clears the tail after them. Group must be idle.
+static bool i2sResize(uint16_t pixels) {
+  if (pixels > i2sGroup.capacity) return false;
+  i2sGroup.pixels = pixels;
+  if (pixels > i2sGroup.peakPixels) i2sGroup.peakPixels = pixels;
+  if (pixels == 0) return true;
+  const size_t bytes = i2sFrameBytes(pixels);
+  const size_t count = (bytes + PIXEL_I2S_DESCRIPTOR_BYTES - 1) / PIXEL_I2S_DESCRIPTOR_BYTES;
+  memset(i2sGroup.samples + bytes - PIXEL_I2S_TAIL_BYTES, 0, PIXEL_I2S_TAIL_BYTES);
+  for (size_t d = 0; d < count; d++) {
+    const size_t offset = d * PIXEL_I2S_DESCRIPTOR_BYTES;
+    const size_t length = bytes - offset < PIXEL_I2S_DESCRIPTOR_BYTES ? bytes - offset : PIXEL_I2S_DESCRIPTOR_BYTES;
+    lldesc_t& desc = i2sGroup.descriptors[d];
+    desc.size = length;
+    desc.length = length;
+    desc.offset = 0;
+    desc.sosf = 0;
+    desc.eof = d + 1 == count;
+    desc.owner = 1;
+    desc.buf = i2sGroup.samples + offset;
+    desc.qe.stqe_next = d + 1 < count ? &i2sGroup.descriptors[d + 1] : nullptr;
+  }
+  return true;
+}
+
+static bool i2sLaneOpen(uint8_t lane, PixelOutput& out) {
+  i2sWaitIdle();
+  if (!i2sGroup.configured) i2sConfigure();
+  if (out.count > i2sGroup.pixels && !i2sResize(out.count)) return false;
+  pinMode(out.pin, OUTPUT);
+  pinMatrixOutAttach(out.pin, I2S1O_DATA_OUT0_IDX + lane, false, false);
+  i2sGroup.laneMask |= 1u << lane;
+  return true;
+}
+
+// Shortens the DMA frame to the longest lane left.
+static void i2sLaneClose(uint8_t lane, PixelOutput& out) {
+  i2sWaitIdle();
+  i2sGroup.laneMask &= ~(1u << lane);
+  pinMatrixOutDetach(out.pin, false, false);
+  uint16_t longest = 0;
+  for (uint8_t l = 0; l < PIXEL_I2S_LANES; l++) {
+    if ((i2sGroup.laneMask & (1u << l)) && pixelOutputs[l].count > longest) longest = pixelOutputs[l].count;
+  }
+  if (longest < i2sGroup.pixels) i2sResize(longest);
+}
+
+// 8x8 bit transpose (Hacker's Delight 7-3): in[l] is lane l's byte, planes[b] gets bit
+// 7 - b of every lane with lane l in bit l, so planes go out MSB first.
+static inline void transposeLanes(const uint8_t* in, uint8_t* planes) {
+  uint32_t x = ((uint32_t)in[7] << 24) | ((uint32_t)in[6] << 16) | ((uint32_t)in[5] << 8) | in[4];
+  uint32_t y = ((uint32_t)in[3] << 24) | ((uint32_t)in[2] << 16) | ((uint32_t)in[1] << 8) | in[0];
+  uint32_t t;
+  t = (x ^ (x >> 7)) & 0x00AA00AAu;
+  x ^= t ^ (t << 7);
+  t = (y ^ (y >> 7)) & 0x00AA00AAu;
+  y ^= t ^ (t << 7);
+  t = (x ^ (x >> 14)) & 0x0000CCCCu;
+  x ^= t ^ (t << 14);
+  t = (y ^ (y >> 14)) & 0x0000CCCCu;
+  y ^= t ^ (t << 14);
+  t = (x & 0xF0F0F0F0u) | ((y >> 4) & 0x0F0F0F0Fu);
+  y = ((x << 4) & 0xF0F0F0F0u) | (y & 0x0F0F0F0Fu);
+  x = t;
+  planes[0] = x >> 24;
+  planes[1] = x >> 16;
+  planes[2] = x >> 8;
+  planes[3] = x;
+  planes[4] = y >> 24;
+  planes[5] = y >> 16;
+  planes[6] = y >> 8;
+  planes[7] = y;
+}
+
+// In 8-bit mode the FIFO sends each word's bytes in the order 2, 3, 0, 1.
+static inline uint32_t i2sSampleWord(uint8_t s0, uint8_t s1, uint8_t s2, uint8_t s3) {
+  return s2 | ((uint32_t)s3 << 8) | ((uint32_t)s0 << 16) | ((uint32_t)s1 << 24);
+}
+
+// Encodes every lane's back buffer into the DMA frame and starts it; the back buffers are
+// not read again, so no front copies are needed.
+static void i2sSend() {
+  const uint8_t mask = i2sGroup.laneMask;
+  const uint8_t* lanes[PIXEL_I2S_LANES];
+  size_t laneBytes[PIXEL_I2S_LANES];
+  for (uint8_t l = 0; l < PIXEL_I2S_LANES; l++) {
+    PixelOutput& out = pixelOutputs[l];
+    const bool active = (mask & (1u << l)) != 0;
+    lanes[l] = active ? out.back : nullptr;
+    laneBytes[l] = active ? frameBytes(out) : 0;
+    out.pending = false;
+  }
+  uint32_t* words = reinterpret_cast<uint32_t*>(i2sGroup.samples);
+  const size_t bytes = (size_t)i2sGroup.pixels * PIXEL_OUTPUT_BYTES_PER_PIXEL;
+  uint8_t in[PIXEL_I2S_LANES];
+  uint8_t p[8];
+  for (size_t j = 0; j < bytes; j++) {
+    // Past its own length a lane sends 0 bits (its high sample is still in the mask).
+    for (uint8_t l = 0; l < PIXEL_I2S_LANES; l++) in[l] = j < laneBytes[l] ? lanes[l][j] : 0;
+    transposeLanes(in, p);
+    // Samples: mask, p[b], 0 per bit.
+    *words++ = i2sSampleWord(mask, p[0], 0, mask);
+    *words++ = i2sSampleWord(p[1], 0, mask, p[2]);
+    *words++ = i2sSampleWord(0, mask, p[3], 0);
+    *words++ = i2sSampleWord(mask, p[4], 0, mask);
+    *words++ = i2sSampleWord(p[5], 0, mask, p[6]);
+    *words++ = i2sSampleWord(0, mask, p[7], 0);
+  }
+
+  I2S1.conf.tx_start = 0;
+  I2S1.conf.tx_reset = 1;
+  I2S1.conf.tx_reset = 0;
+  I2S1.conf.tx_fifo_reset = 1;
+  I2S1.conf.tx_fifo_reset = 0;
+  I2S1.lc_conf.out_rst = 1;
+  I2S1.lc_conf.out_rst = 0;
+  I2S1.int_clr.val = I2S1.int_raw.val;
+  I2S1.out_link.addr = (uint32_t)(uintptr_t)i2sGroup.descriptors & 0xFFFFF;
+  I2S1.out_link.start = 1;
+  I2S1.conf.tx_start = 1;
+  i2sGroup.startUs = micros();
+  i2sGroup.sending = true;
+}
+
+// Frame arena: one block reserved at boot that every back (and RMT front) buffer is a view
+// into, so re-attaching strips on config edits never touches the heap. Views are placed
+// first-fit; when only the gaps between them would fit, the arena is compacted first.
+struct PixelArena {
+  uint8_t* base = nullptr;
+  uint32_t bytes = 0;
+  bool reserved = false;
+  // What the reservation covers: pixels in total and, with the DMA frame, the longest strip.
+  uint32_t pixels = 0;
+  uint16_t lanePixels = 0;
+};
+
+static PixelArena pixelArena;
+
+struct ArenaView {
+  uint8_t** owner;
+  size_t bytes;
+};
+
+static constexpr uint8_t PIXEL_ARENA_MAX_VIEWS = 2 * PIXEL_OUTPUT_COUNT;
+
+// Every live view, by address.
+static uint8_t collectArenaViews(ArenaView* views) {
+  uint8_t n = 0;
+  for (auto& out : pixelOutputs) {
+    if (out.back) views[n++] = ArenaView{&out.back, frameBytes(out)};
+    if (out.front) views[n++] = ArenaView{&out.front, frameBytes(out)};
+  }
+  for (uint8_t i = 1; i < n; i++) {
+    ArenaView view = views[i];
+    uint8_t j = i;
+    for (; j > 0 && *views[j - 1].owner > *view.owner; j--) views[j] = views[j - 1];
+    views[j] = view;
+  }
+  return n;
+}
+
+static uint8_t* arenaFirstFit(size_t bytes) {
+  if (!pixelArena.base) return nullptr;
+  ArenaView views[PIXEL_ARENA_MAX_VIEWS];
+  const uint8_t n = collectArenaViews(views);
+  uint8_t* cursor = pixelArena.base;
+  for (uint8_t v = 0; v < n; v++) {
+    if ((size_t)(*views[v].owner - cursor) >= bytes) return cursor;
+    cursor = *views[v].owner + views[v].bytes;
+  }
+  return (size_t)(pixelArena.base + pixelArena.bytes - cursor) >= bytes ? cursor : nullptr;
+}
+
+// Slides every view down to the start of the arena. RMT fronts are read by the translator
+// until their send is over, so those finish first; back buffers are only read by a send.
+static void arenaCompact() {
+  for (uint8_t o = PIXEL_I2S_LANES; o < PIXEL_OUTPUT_COUNT; o++) {
+    auto& out = pixelOutputs[o];
+    if (!out.sending) continue;
+    rmt_wait_tx_done(rmtChannel(o), pdMS_TO_TICKS(PIXEL_DETACH_WAIT_MS));
+    out.sending = false;
+  }
+  ArenaView views[PIXEL_ARENA_MAX_VIEWS];
+  const uint8_t n = collectArenaViews(views);
+  uint8_t* cursor = pixelArena.base;
+  for (uint8_t v = 0; v < n; v++) {
+    if (*views[v].owner != cursor) {
+      memmove(cursor, *views[v].owner, views[v].bytes);
+      *views[v].owner = cursor;
+    }
+    cursor += views[v].bytes;
+  }
+}
+
+static uint8_t* arenaAlloc(size_t bytes) {
+  uint8_t* view = arenaFirstFit(bytes);
+  if (!view && pixelArena.bytes - frameUsage.used >= bytes) {
+    arenaCompact();
+    view = arenaFirstFit(bytes);
+  }
+  if (!view) return nullptr;
+  memset(view, 0, bytes);
+  frameUsageAdd(bytes);
+  return view;
+}
+
+static void arenaFree(uint8_t*& view, size_t bytes) {
+  if (!view) return;
+  frameUsageRemove(bytes);
+  view = nullptr;
+}
+
+// Largest run of free arena bytes, without compacting.
+static uint32_t arenaLargestFree() {
+  if (!pixelArena.base) return 0;
+  ArenaView views[PIXEL_ARENA_MAX_VIEWS];
+  const uint8_t n = collectArenaViews(views);
+  uint8_t* cursor = pixelArena.base;
+  size_t largest = 0;
+  for (uint8_t v = 0; v < n; v++) {
+    const size_t gap = *views[v].owner - cursor;
+    if (gap > largest) largest = gap;
+    cursor = *views[v].owner + views[v].bytes;
+  }
+  const size_t tail = pixelArena.base + pixelArena.bytes - cursor;
+  return tail > largest ? tail : largest;
+}
+
+// 80 MHz / 2 = 25 ns ticks.
+static constexpr uint8_t PIXEL_RMT_CLOCK_DIV = 2;
+static constexpr uint32_t pixelRmtItem(uint32_t highTicks, uint32_t lowTicks) {
+  return highTicks | (1u << 15) | (lowTicks << 16);
+}
+static constexpr uint32_t PIXEL_RMT_BIT0 = pixelRmtItem(16, 34);
+static constexpr uint32_t PIXEL_RMT_BIT1 = pixelRmtItem(32, 18);
+
+// Runs in the RMT interrupt whenever the channel memory needs refilling: one item per bit,
+// MSB first, whole bytes only.
+static void IRAM_ATTR translateWs2812(const void* src, rmt_item32_t* dest, size_t srcSize, size_t wanted,
+                                      size_t* translated, size_t* itemCount) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(src);
+  size_t n = 0;
+  size_t items = 0;
+  while (n < srcSize && items + 8 <= wanted) {
+    uint8_t b = bytes[n++];
+    for (uint8_t bit = 0; bit < 8; bit++, b <<= 1) dest[items++].val = (b & 0x80) ? PIXEL_RMT_BIT1 : PIXEL_RMT_BIT0;
+  }
+  *translated = n;
+  *itemCount = items;
+}
+
+static bool rmtOpen(uint8_t output, PixelOutput& out) {
+  out.front = arenaAlloc(frameBytes(out));
+  if (!out.front) return false;
+  rmt_config_t config = RMT_DEFAULT_CONFIG_TX((gpio_num_t)out.pin, rmtChannel(output));
+  config.clk_div = PIXEL_RMT_CLOCK_DIV;
+  config.tx_config.idle_output_en = true;
+  config.tx_config.idle_level = RMT_IDLE_LEVEL_LOW;
+  if (rmt_config(&config) != ESP_OK || rmt_driver_install(rmtChannel(output), 0, 0) != ESP_OK) {
+    arenaFree(out.front, frameBytes(out));
+    return false;
+  }
+  rmt_translator_init(rmtChannel(output), translateWs2812);
+  return true;
+}
+
+static void rmtClose(uint8_t output, PixelOutput& out) {
+  rmt_wait_tx_done(rmtChannel(output), pdMS_TO_TICKS(PIXEL_DETACH_WAIT_MS));
+  rmt_driver_uninstall(rmtChannel(output));
+  pinMatrixOutDetach(out.pin, false, false);
+  arenaFree(out.front, frameBytes(out));
+}
+
+static bool rmtIdle(uint8_t output, PixelOutput& out) {
+  if (!out.sending) return true;
+  if (!frameTimeElapsed(out.startUs, out.count)) return false;
+  if (rmt_wait_tx_done(rmtChannel(output), 0) != ESP_OK) return false;
+  out.sending = false;
+  return true;
+}
+
+// The shown frame becomes the front buffer; the back buffer starts from a copy of it.
+static void rmtSend(uint8_t output, PixelOutput& out) {
+  uint8_t* shown = out.back;
+  out.back = out.front;
+  out.front = shown;
+  memcpy(out.back, out.front, frameBytes(out));
+  out.pending = false;
+  rmt_write_sample(rmtChannel(output), out.front, frameBytes(out), false);
+  out.startUs = micros();
+  out.sending = true;
+}
+
+static bool openOutput(uint8_t output, PixelOutput& out) {
+  out.back = arenaAlloc(frameBytes(out));
+  if (!out.back) return false;
+  if (output < PIXEL_I2S_LANES ? i2sLaneOpen(output, out) : rmtOpen(output, out)) return true;
+  arenaFree(out.back, frameBytes(out));
+  return false;
+}
+
+static void closeOutput(uint8_t output, PixelOutput& out) {
+  if (output < PIXEL_I2S_LANES) {
+    i2sLaneClose(output, out);
+  } else {
+    rmtClose(output, out);
+  }
+  arenaFree(out.back, frameBytes(out));
+}
+
+static bool outputIdle(uint8_t output, PixelOutput& out) {
+  return output < PIXEL_I2S_LANES ? i2sIdle() : rmtIdle(output, out);
+}
+
+// A lane sends the whole group, clearing every lane's pending frame.
+static void sendFrame(uint8_t output, PixelOutput& out) {
+  if (output < PIXEL_I2S_LANES) {
+    i2sSend();
+  } else {
+    rmtSend(output, out);
+  }
+}
+
+void pixelOutputReserve(uint32_t pixels, uint16_t lanePixels) {
+  if (pixelArena.reserved) return;
+  pixelArena.reserved = true;
+  const bool lanes = lanePixels > 0 && i2sReserve(lanePixels);
+  // Without the DMA frame every strip goes to RMT and needs a front buffer as well.
+  const uint32_t bytes = pixels * PIXEL_OUTPUT_BYTES_PER_PIXEL * (lanes || lanePixels == 0 ? 1 : 2);
+  if (bytes == 0) return;
+  pixelArena.base = new (std::nothrow) uint8_t[bytes];
+  pixelArena.bytes = pixelArena.base ? bytes : 0;
+  if (!pixelArena.base) return;
+  pixelArena.pixels = pixels;
+  // Without the DMA frame strips of any length go to RMT.
+  pixelArena.lanePixels = lanes ? lanePixels : 0xFFFF;
+}
+
+bool pixelOutputFits(uint32_t pixels, uint16_t lanePixels) {
+  return pixels == 0 || (pixels <= pixelArena.pixels && lanePixels <= pixelArena.lanePixels);
+}
+
+static void backendMemory(PixelOutputMemory& memory) {
+  memory.arenaBytes = pixelArena.bytes;
+  memory.arenaLargestFree = arenaLargestFree();
+  memory.dmaBytes = i2sGroup.capacity ? i2sFrameBytes(i2sGroup.capacity) : 0;
+  memory.dmaPixels = i2sGroup.capacity;
+  memory.dmaPeakPixels = i2sGroup.peakPixels;
+  memory.heapFree = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+  memory.heapLargest = heap_caps_get_largest_free_block(MALLOC_CAP_DMA);
+  // A pixel more at the next boot costs its back buffer plus a lane of DMA frame.
+  memory.headroomPixels = memory.heapLargest / (PIXEL_OUTPUT_BYTES_PER_PIXEL * (PIXEL_I2S_SAMPLES_PER_BYTE + 1));
+}
+
+#else
+
+// Adafruit's show() blocks for the whole frame (about 30 us per pixel).
+static constexpr uint8_t PIXEL_OUTPUT_COUNT = 8;
+
+static PixelOutput pixelOutputs[PIXEL_OUTPUT_COUNT];
+// The back buffer is the strip's own pixel buffer (show() sends it as it is, so the caller's
+// encoding sets the color order and NEO_GRB only fixes the 3-byte layout).
+static Adafruit_NeoPixel pixelStrips[PIXEL_OUTPUT_COUNT];
+
+static bool openOutput(uint8_t output, PixelOutput& out) {
+  Adafruit_NeoPixel& strip = pixelStrips[output];
+  strip.updateType(NEO_GRB + NEO_KHZ800);
+  strip.setPin(out.pin);
+  if (strip.numPixels() != out.count || !strip.getPixels()) strip.updateLength(out.count);
+  out.back = strip.getPixels();
+  if (!out.back) return false;
+  memset(out.back, 0, frameBytes(out));
+  strip.begin();
+  frameUsageAdd(frameBytes(out));
+  return true;
+}
+
+// A begun strip stays begun, and its next setPin() would switch the old pin to an input even
+// after a relay or LED took it over. Rebuilding the strip releases the pin (the destructor
+// sets it to input and frees the buffer) while this output still owns it.
+static void closeOutput(uint8_t output, PixelOutput& out) {
+  Adafruit_NeoPixel& strip = pixelStrips[output];
+  strip.~Adafruit_NeoPixel();
+  new (&strip) Adafruit_NeoPixel();
+  frameUsageRemove(frameBytes(out));
+  out.back = nullptr;
+}
+
+static bool outputIdle(uint8_t output, PixelOutput&) {
+  return pixelStrips[output].canShow();
+}
+
+static void sendFrame(uint8_t output, PixelOutput& out) {
+  out.pending = false;
+  pixelStrips[output].show();
+}
+
+// The strips allocate their own buffers, so there is nothing to reserve.
+void pixelOutputReserve(uint32_t, uint16_t) {}
+bool pixelOutputFits(uint32_t, uint16_t) { return true; }
+
+static void backendMemory(PixelOutputMemory& memory) {
+  memory.arenaBytes = 0;
+  memory.arenaLargestFree = 0;
+  memory.dmaBytes = 0;
+  memory.dmaPixels = 0;
+  memory.dmaPeakPixels = 0;
+  memory.heapFree = ESP.getFreeHeap();
+#if defined(ESP8266)
+  memory.heapLargest = ESP.getMaxFreeBlockSize();
+#else
+  memory.heapLargest = ESP.getMaxAllocHeap();
+#endif
+  memory.headroomPixels = memory.heapLargest / PIXEL_OUTPUT_BYTES_PER_PIXEL;
+}
+
+#endif
+
+static PixelOutput* attachedOutput(uint8_t output) {
+  if (output >= PIXEL_OUTPUT_COUNT || !pixelOutputs[output].attached) return nullptr;
+  return &pixelOutputs[output];
+}
+
+// Outputs are tried in order, so a strip the first free one cannot take (longer than the
+// DMA frame) falls through to the next.
+uint8_t pixelOutputAttach(uint8_t pin, uint16_t count) {
+  if (count == 0) return PIXEL_OUTPUT_NONE;
+  for (uint8_t o = 0; o < PIXEL_OUTPUT_COUNT; o++) {
+    auto& out = pixelOutputs[o];
+    if (out.attached) continue;
+    out.pin = pin;
+    out.count = count;
+    if (openOutput(o, out)) {
+      out.attached = true;
+      return o;
+    }
+    out = PixelOutput();
+  }
+  frameUsage.refused++;
+  return PIXEL_OUTPUT_NONE;
+}
+
+void pixelOutputDetach(uint8_t output) {
+  PixelOutput* out = attachedOutput(output);
+  if (!out) return;
+  closeOutput(output, *out);
+  *out = PixelOutput();
+}
+
+uint8_t* pixelOutputBuffer(uint8_t output) {
+  PixelOutput* out = attachedOutput(output);
+  return out ? out->back : nullptr;
+}
+
+void pixelOutputShow(uint8_t output) {
+  PixelOutput* out = attachedOutput(output);
+  if (out) out->pending = true;
+}
+
+bool pixelOutputFlush() {
+  bool waiting = false;
+  for (uint8_t o = 0; o < PIXEL_OUTPUT_COUNT; o++) {
+    auto& out = pixelOutputs[o];
+    if (!out.attached || !out.pending) continue;
+    if (!outputIdle(o, out)) {
+      waiting = true;
+      continue;
+    }
+    sendFrame(o, out);
+  }
+  return waiting;
+}
+
+void pixelOutputMemory(PixelOutputMemory& memory) {
+  backendMemory(memory);
+  memory.framesUsed = frameUsage.used;
+  memory.framesPeak = frameUsage.peak;
+  memory.refused = frameUsage.refused;
+}
+
+#else
+
+uint8_t pixelOutputAttach(uint8_t, uint16_t) { return PIXEL_OUTPUT_NONE; }
+void pixelOutputDetach(uint8_t) {}
+uint8_t* pixelOutputBuffer(uint8_t) { return nullptr; }
+void pixelOutputShow(uint8_t) {}
+bool pixelOutputFlush() { return false; }
+void pixelOutputReserve(uint32_t, uint16_t) {}
+bool pixelOutputFits(uint32_t, uint16_t) { return true; }
+void pixelOutputMemory(PixelOutputMemory& memory) { memory = PixelOutputMemory(); }
+
+#endif
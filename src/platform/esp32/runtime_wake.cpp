@@ -0,0 +1,45 @@
+#include "platform/runtime_wake.h"
+
+#if defined(ESP32)
+
+#include <Arduino.h>
+#include <atomic>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+static std::atomic<TaskHandle_t> runtimeTask(nullptr);
+
+void runtimeWakeBind() {
+  runtimeTask.store(xTaskGetCurrentTaskHandle(), std::memory_order_release);
+}
+
+void runtimeWakeNotify() {
+  TaskHandle_t task = runtimeTask.load(std::memory_order_acquire);
+  if (task) xTaskNotifyGive(task);
+}
+
+void IRAM_ATTR runtimeWakeNotifyFromIsr() {
+  TaskHandle_t task = runtimeTask.load(std::memory_order_acquire);
+  if (!task) return;
+  BaseType_t woken = pdFALSE;
+  vTaskNotifyGiveFromISR(task, &woken);
+  if (woken) portYIELD_FROM_ISR();
+}
+
+void runtimeWakeWait(uint32_t timeoutMs) {
+  // Notifications given while the runtime was busy make this return at once.
+  ulTaskNotifyTake(pdTRUE, (TickType_t)((timeoutMs + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS));
+}
+
+#else
+
+#include <Arduino.h>
+
+void runtimeWakeBind() {}
+void runtimeWakeNotify() {}
+// Called from IRAM interrupts, so it must not live in flash either.
+void IRAM_ATTR runtimeWakeNotifyFromIsr() {}
+void runtimeWakeWait(uint32_t timeoutMs) { delay(timeoutMs); }
+
+#endif
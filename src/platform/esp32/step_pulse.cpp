@@ -0,0 +1,122 @@
+#include "platform/step_pulse.h"
+
+#if defined(ESP32) && CONFIG_IDF_TARGET_ESP32
+
+#include <Arduino.h>
+#include "driver/rmt.h"
+#include "soc/rmt_struct.h"
+
+// RMT at 80 MHz / 80 = 1 us ticks; each item is one pulse (high, then low until the next).
+static constexpr uint8_t STEP_PULSE_CLOCK_DIV = 80;
+// Channels 0..3 drive pixel strips (platform/pixel_output); STEP/DIR axes take the top four,
+// each with its own 64-item memory block.
+static constexpr uint8_t STEP_PULSE_FIRST_CHANNEL = 4;
+static constexpr uint8_t STEP_PULSE_CHANNELS = RMT_CHANNEL_MAX - STEP_PULSE_FIRST_CHANNEL;
+
+struct StepPulseChannel {
+  bool attached = false;
+  bool started = false;
+  uint8_t pin = 0;
+};
+
+static StepPulseChannel stepPulseChannels[STEP_PULSE_CHANNELS];
+
+static inline uint8_t STEP_TIMER_ISR_ATTR rmtChannel(uint8_t channel) {
+  return (uint8_t)(STEP_PULSE_FIRST_CHANNEL + channel);
+}
+
+static inline uint32_t STEP_TIMER_ISR_ATTR txEndBit(uint8_t channel) {
+  return 1u << (rmtChannel(channel) * 3);
+}
+
+static inline uint32_t STEP_TIMER_ISR_ATTR rmtItem(uint32_t level0, uint32_t duration0, uint32_t level1, uint32_t duration1) {
+  return duration0 | (level0 << 15) | (duration1 << 16) | (level1 << 31);
+}
+
+static void STEP_TIMER_ISR_ATTR stopChannel(uint8_t channel) {
+  const uint8_t rmt = rmtChannel(channel);
+  RMTMEM.chan[rmt].data32[0].val = 0;
+  RMT.conf_ch[rmt].conf1.tx_start = 0;
+  RMT.conf_ch[rmt].conf1.mem_rd_rst = 1;
+  RMT.conf_ch[rmt].conf1.mem_rd_rst = 0;
+  stepPulseChannels[channel].started = false;
+}
+
+// Configuration goes through the IDF driver (clock, idle level, pin routing); no driver is
+// installed, so sending is plain register access.
+uint8_t stepPulseAttach(uint8_t stepPin) {
+  for (uint8_t c = 0; c < STEP_PULSE_CHANNELS; c++) {
+    if (stepPulseChannels[c].attached) continue;
+    rmt_config_t config = RMT_DEFAULT_CONFIG_TX((gpio_num_t)stepPin, (rmt_channel_t)rmtChannel(c));
+    config.clk_div = STEP_PULSE_CLOCK_DIV;
+    config.tx_config.idle_output_en = true;
+    config.tx_config.idle_level = RMT_IDLE_LEVEL_LOW;
+    if (rmt_config(&config) != ESP_OK) return STEP_PULSE_NO_CHANNEL;
+    RMT.apb_conf.fifo_mask = 1;
+    stepPulseChannels[c].attached = true;
+    stepPulseChannels[c].pin = stepPin;
+    stopChannel(c);
+    return c;
+  }
+  return STEP_PULSE_NO_CHANNEL;
+}
+
+void stepPulseDetach(uint8_t channel) {
+  if (channel >= STEP_PULSE_CHANNELS || !stepPulseChannels[channel].attached) return;
+  stopChannel(channel);
+  pinMatrixOutDetach(stepPulseChannels[channel].pin, false, false);
+  stepPulseChannels[channel].attached = false;
+}
+
+bool STEP_TIMER_ISR_ATTR stepPulseIdle(uint8_t channel) {
+  if (channel >= STEP_PULSE_CHANNELS || !stepPulseChannels[channel].started) return true;
+  return (RMT.int_raw.val & txEndBit(channel)) != 0;
+}
+
+bool STEP_TIMER_ISR_ATTR stepPulseSend(uint8_t channel, const uint32_t* gapsUs, uint8_t count) {
+  if (channel >= STEP_PULSE_CHANNELS || !stepPulseChannels[channel].attached || count == 0) return false;
+  if (!stepPulseIdle(channel)) return false;
+  if (count > STEP_PULSE_MAX_BATCH) count = STEP_PULSE_MAX_BATCH;
+
+  volatile auto& mem = RMTMEM.chan[rmtChannel(channel)];
+  uint8_t n = 0;
+  for (; n < count; n++) {
+    uint32_t gap = n + 1 < count ? gapsUs[n] : 0;
+    if (gap > STEP_PULSE_MAX_GAP_US) gap = STEP_PULSE_MAX_GAP_US;
+    // A zero duration would end the batch early.
+    uint32_t low = gap > STEP_PULSE_WIDTH_US ? gap - STEP_PULSE_WIDTH_US : 1;
+    mem.data32[n].val = rmtItem(1, STEP_PULSE_WIDTH_US, 0, low);
+  }
+  mem.data32[n].val = 0;
+
+  const uint8_t rmt = rmtChannel(channel);
+  RMT.int_clr.val = txEndBit(channel);
+  RMT.conf_ch[rmt].conf1.mem_rd_rst = 1;
+  RMT.conf_ch[rmt].conf1.mem_rd_rst = 0;
+  RMT.conf_ch[rmt].conf1.tx_start = 1;
+  stepPulseChannels[channel].started = true;
+  return true;
+}
+
+void stepPulseWaitIdle(uint8_t channel, uint32_t timeoutUs) {
+  const uint32_t startUs = micros();
+  while (!stepPulseIdle(channel) && micros() - startUs < timeoutUs) delayMicroseconds(10);
+}
+
+void STEP_TIMER_ISR_ATTR stepPulseAbort(uint8_t channel) {
+  if (channel >= STEP_PULSE_CHANNELS || !stepPulseChannels[channel].attached) return;
+  stopChannel(channel);
+}
+
+#else
+
+// ESP8266 and the newer ESP32 variants (different RMT layout) pulse STEP from the step timer.
+// The stubs called from the step timer and switch interrupts stay in IRAM like the real ones.
+uint8_t stepPulseAttach(uint8_t) { return STEP_PULSE_NO_CHANNEL; }
+void stepPulseDetach(uint8_t) {}
+bool STEP_TIMER_ISR_ATTR stepPulseSend(uint8_t, const uint32_t*, uint8_t) { return false; }
+bool STEP_TIMER_ISR_ATTR stepPulseIdle(uint8_t) { return true; }
+void stepPulseWaitIdle(uint8_t, uint32_t) {}
+void STEP_TIMER_ISR_ATTR stepPulseAbort(uint8_t) {}
+
+#endif
@@ -0,0 +1,100 @@
+#include "platform/step_timer.h"
+
+#if defined(ESP32)
+
+#include <esp_timer.h>
+#include "freertos/FreeRTOS.h"
+
+static esp_timer_handle_t stepTimerHandle = nullptr;
+static StepTimerCallback stepTimerCallback = nullptr;
+static portMUX_TYPE stepTimerMux = portMUX_INITIALIZER_UNLOCKED;
+
+static void STEP_TIMER_ISR_ATTR onStepTimer(void* arg) {
+  (void)arg;
+  if (stepTimerCallback) stepTimerCallback();
+}
+
+bool stepTimerBegin(StepTimerCallback callback) {
+  stepTimerCallback = callback;
+  if (stepTimerHandle) return true;
+
+  esp_timer_create_args_t args = {};
+  args.callback = onStepTimer;
+  args.arg = nullptr;
+  // ISR dispatch when the SDK allows it, otherwise the high-priority esp_timer task.
+#if CONFIG_ESP_TIMER_SUPPORTS_ISR_DISPATCH_METHOD
+  args.dispatch_method = ESP_TIMER_ISR;
+#else
+  args.dispatch_method = ESP_TIMER_TASK;
+#endif
+  args.name = "step-timer";
+  return esp_timer_create(&args, &stepTimerHandle) == ESP_OK;
+}
+
+void STEP_TIMER_ISR_ATTR stepTimerArm(uint32_t delayUs) {
+  if (!stepTimerHandle) return;
+  esp_timer_stop(stepTimerHandle);
+  esp_timer_start_once(stepTimerHandle, delayUs);
+}
+
+void STEP_TIMER_ISR_ATTR stepTimerDisarm() {
+  if (stepTimerHandle) esp_timer_stop(stepTimerHandle);
+}
+
+uint32_t STEP_TIMER_ISR_ATTR stepTimerNowUs() {
+  return (uint32_t)esp_timer_get_time();
+}
+
+// portMUX critical sections nest on the owning core.
+void STEP_TIMER_ISR_ATTR stepTimerLock() {
+  portENTER_CRITICAL(&stepTimerMux);
+}
+
+void STEP_TIMER_ISR_ATTR stepTimerUnlock() {
+  portEXIT_CRITICAL(&stepTimerMux);
+}
+
+#elif defined(ESP8266)
+
+static StepTimerCallback stepTimerCallback = nullptr;
+static uint32_t stepTimerLockDepth = 0;
+static uint32_t stepTimerSavedLevel = 0;
+
+// timer1 at TIM_DIV16 ticks at 5 MHz.
+static constexpr uint32_t STEP_TIMER_TICKS_PER_US = 5;
+
+static void STEP_TIMER_ISR_ATTR onStepTimer() {
+  if (stepTimerCallback) stepTimerCallback();
+}
+
+bool stepTimerBegin(StepTimerCallback callback) {
+  stepTimerCallback = callback;
+  timer1_attachInterrupt(onStepTimer);
+  return true;
+}
+
+void STEP_TIMER_ISR_ATTR stepTimerArm(uint32_t delayUs) {
+  if (delayUs < 2) delayUs = 2;
+  timer1_enable(TIM_DIV16, TIM_EDGE, TIM_SINGLE);
+  timer1_write(delayUs * STEP_TIMER_TICKS_PER_US);
+}
+
+void STEP_TIMER_ISR_ATTR stepTimerDisarm() {
+  timer1_disable();
+}
+
+uint32_t STEP_TIMER_ISR_ATTR stepTimerNowUs() {
+  return micros();
+}
+
+void STEP_TIMER_ISR_ATTR stepTimerLock() {
+  uint32_t level = xt_rsil(15);
+  if (stepTimerLockDepth++ == 0) stepTimerSavedLevel = level;
+}
+
+void STEP_TIMER_ISR_ATTR stepTimerUnlock() {
+  if (stepTimerLockDepth == 0) return;
+  if (--stepTimerLockDepth == 0) xt_wsr_ps(stepTimerSavedLevel);
+}
+
+#endif
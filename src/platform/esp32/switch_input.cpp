@@ -0,0 +1,72 @@
+#include "platform/switch_input.h"
+
+#if defined(ESP32) || defined(ESP8266)
+
+#include <Arduino.h>
+
+#if defined(ESP32)
+#include "soc/gpio_struct.h"
+static constexpr uint8_t SWITCH_INPUT_PINS = SOC_GPIO_PIN_COUNT;
+#else
+// GPIO16 reads through its own register and has no edge interrupt.
+static constexpr uint8_t SWITCH_INPUT_PINS = 17;
+static constexpr uint8_t SWITCH_INPUT_NO_IRQ_PIN = 16;
+#endif
+
+struct SwitchInput {
+  SwitchInputHandler handler = nullptr;
+  void* arg = nullptr;
+  uint8_t pin = 0;
+  bool activeLow = true;
+};
+
+static SwitchInput switchInputs[SWITCH_INPUT_PINS];
+
+bool STEP_TIMER_ISR_ATTR switchInputActive(uint8_t pin, bool activeLow) {
+  if (pin >= SWITCH_INPUT_PINS) return false;
+#if defined(ESP32)
+#if SOC_GPIO_PIN_COUNT > 32
+  bool level = pin < 32 ? ((GPIO.in >> pin) & 1u) != 0 : ((GPIO.in1.data >> (pin - 32)) & 1u) != 0;
+#else
+  bool level = ((GPIO.in >> pin) & 1u) != 0;
+#endif
+#else
+  bool level = pin == SWITCH_INPUT_NO_IRQ_PIN ? (GP16I & 0x01) != 0 : GPIP(pin) != 0;
+#endif
+  return activeLow ? !level : level;
+}
+
+static void STEP_TIMER_ISR_ATTR onSwitchEdge(void* arg) {
+  const SwitchInput& input = *static_cast<const SwitchInput*>(arg);
+  if (input.handler) input.handler(input.arg, switchInputActive(input.pin, input.activeLow));
+}
+
+bool switchInputAttach(uint8_t pin, bool activeLow, SwitchInputHandler handler, void* arg) {
+  if (pin >= SWITCH_INPUT_PINS) return false;
+  pinMode(pin, activeLow ? INPUT_PULLUP : INPUT);
+#if !defined(ESP32)
+  if (pin == SWITCH_INPUT_NO_IRQ_PIN) return false;
+#endif
+  detachInterrupt(pin);
+  SwitchInput& input = switchInputs[pin];
+  input.handler = handler;
+  input.arg = arg;
+  input.pin = pin;
+  input.activeLow = activeLow;
+  attachInterruptArg(pin, onSwitchEdge, &input, CHANGE);
+  return true;
+}
+
+void switchInputDetach(uint8_t pin) {
+  if (pin >= SWITCH_INPUT_PINS || !switchInputs[pin].handler) return;
+  detachInterrupt(pin);
+  switchInputs[pin] = SwitchInput();
+}
+
+#else
+
+bool switchInputAttach(uint8_t, bool, SwitchInputHandler, void*) { return false; }
+void switchInputDetach(uint8_t) {}
+bool switchInputActive(uint8_t, bool) { return false; }
+
+#endif
@@ -0,0 +1,151 @@
+#include "platform/esp32/udp_transport.h"
+
+#include "core/features.h"
+
+#if USE_SACN
+
+#include <string.h>
+
+#if defined(ESP32)
+#include <lwip/sockets.h>
+#elif defined(ESP8266)
+#include <lwip/igmp.h>
+#else
+#error "Unsupported platform for UDP transport"
+#endif
+
+#if defined(ESP32)
+
+bool udpOpen(UdpEndpoint& endpoint, uint16_t port) {
+  udpClose(endpoint);
+  endpoint.socket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+  if (endpoint.socket < 0) return false;
+
+  int enable = 1;
+  setsockopt(endpoint.socket, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+  setsockopt(endpoint.socket, SOL_SOCKET, SO_BROADCAST, &enable, sizeof(enable));
+
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  if (bind(endpoint.socket, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+    close(endpoint.socket);
+    endpoint.socket = -1;
+    return false;
+  }
+  fcntl(endpoint.socket, F_SETFL, O_NONBLOCK);
+  endpoint.open = true;
+  return true;
+}
+
+void udpClose(UdpEndpoint& endpoint) {
+  if (endpoint.socket >= 0) close(endpoint.socket);
+  endpoint.socket = -1;
+  endpoint.open = false;
+}
+
+bool udpJoinGroup(UdpEndpoint& endpoint, uint32_t groupAddr) {
+  struct ip_mreq mreq;
+  mreq.imr_multiaddr.s_addr = htonl(groupAddr);
+  mreq.imr_interface.s_addr = htonl(INADDR_ANY);
+  return setsockopt(endpoint.socket, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) == 0;
+}
+
+void udpLeaveGroup(UdpEndpoint& endpoint, uint32_t groupAddr) {
+  struct ip_mreq mreq;
+  mreq.imr_multiaddr.s_addr = htonl(groupAddr);
+  mreq.imr_interface.s_addr = htonl(INADDR_ANY);
+  setsockopt(endpoint.socket, IPPROTO_IP, IP_DROP_MEMBERSHIP, &mreq, sizeof(mreq));
+}
+
+int udpReceive(UdpEndpoint& endpoint, uint8_t* buf, size_t cap, uint32_t* fromAddr) {
+  struct sockaddr_in from;
+  socklen_t fromLen = sizeof(from);
+  int len = recvfrom(endpoint.socket, buf, cap, MSG_DONTWAIT, (struct sockaddr*)&from, &fromLen);
+  if (len > 0 && fromAddr) *fromAddr = ntohl(from.sin_addr.s_addr);
+  return len;
+}
+
+bool udpWaitReadable(UdpEndpoint* const* endpoints, uint8_t count, uint32_t timeoutMs) {
+  fd_set readable;
+  FD_ZERO(&readable);
+  int maxSocket = -1;
+  for (uint8_t i = 0; i < count; i++) {
+    if (!endpoints[i] || !endpoints[i]->open) continue;
+    FD_SET(endpoints[i]->socket, &readable);
+    if (endpoints[i]->socket > maxSocket) maxSocket = endpoints[i]->socket;
+  }
+  if (maxSocket < 0) {
+    delay(timeoutMs);
+    return false;
+  }
+  struct timeval timeout;
+  timeout.tv_sec = timeoutMs / 1000;
+  timeout.tv_usec = (timeoutMs % 1000) * 1000;
+  return select(maxSocket + 1, &readable, nullptr, nullptr, &timeout) > 0;
+}
+
+bool udpSendTo(UdpEndpoint& endpoint, uint32_t addr, uint16_t port, const uint8_t* data, size_t len) {
+  struct sockaddr_in to;
+  memset(&to, 0, sizeof(to));
+  to.sin_family = AF_INET;
+  to.sin_port = htons(port);
+  to.sin_addr.s_addr = htonl(addr);
+  return sendto(endpoint.socket, data, len, 0, (struct sockaddr*)&to, sizeof(to)) == (int)len;
+}
+
+#elif defined(ESP8266)
+
+static void toIp4(uint32_t addr, ip4_addr_t& out) {
+  IP4_ADDR(&out, (uint8_t)(addr >> 24), (uint8_t)(addr >> 16), (uint8_t)(addr >> 8), (uint8_t)addr);
+}
+
+bool udpOpen(UdpEndpoint& endpoint, uint16_t port) {
+  udpClose(endpoint);
+  endpoint.open = endpoint.udp.begin(port) == 1;
+  return endpoint.open;
+}
+
+void udpClose(UdpEndpoint& endpoint) {
+  if (endpoint.open) endpoint.udp.stop();
+  endpoint.open = false;
+}
+
+bool udpJoinGroup(UdpEndpoint& endpoint, uint32_t groupAddr) {
+  ip4_addr_t group;
+  toIp4(groupAddr, group);
+  return igmp_joingroup(IP4_ADDR_ANY4, &group) == ERR_OK;
+}
+
+void udpLeaveGroup(UdpEndpoint& endpoint, uint32_t groupAddr) {
+  ip4_addr_t group;
+  toIp4(groupAddr, group);
+  igmp_leavegroup(IP4_ADDR_ANY4, &group);
+}
+
+int udpReceive(UdpEndpoint& endpoint, uint8_t* buf, size_t cap, uint32_t* fromAddr) {
+  if (endpoint.udp.parsePacket() <= 0) return -1;
+  if (fromAddr) {
+    IPAddress remote = endpoint.udp.remoteIP();
+    *fromAddr = ((uint32_t)remote[0] << 24) | ((uint32_t)remote[1] << 16) | ((uint32_t)remote[2] << 8) | remote[3];
+  }
+  return endpoint.udp.read(buf, cap);
+}
+
+bool udpWaitReadable(UdpEndpoint* const* endpoints, uint8_t count, uint32_t timeoutMs) {
+  delay(timeoutMs > 0 ? 1 : 0);
+  return false;
+}
+
+bool udpSendTo(UdpEndpoint& endpoint, uint32_t addr, uint16_t port, const uint8_t* data, size_t len) {
+  IPAddress to((uint8_t)(addr >> 24), (uint8_t)(addr >> 16), (uint8_t)(addr >> 8), (uint8_t)addr);
+  if (!endpoint.udp.beginPacket(to, port)) return false;
+  endpoint.udp.write(data, len);
+  return endpoint.udp.endPacket() == 1;
+}
+
+#endif
+
+#endif
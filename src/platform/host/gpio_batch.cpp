@@ -0,0 +1,46 @@
+#include "platform/gpio_batch.h"
+
+#if !defined(ARDUINO)
+
+#include "platform/host/gpio_batch.h"
+
+static uint32_t hostOutputLatch[GPIO_BATCH_BANKS] = {0, 0};
+static uint32_t hostCommitCount = 0;
+static HostGpioCommit hostLastCommit = {};
+
+void gpioBatchCommit(GpioBatch& batch) {
+  bool any = false;
+  for (uint8_t bank = 0; bank < GPIO_BATCH_BANKS; bank++) {
+    if (batch.setMask[bank] || batch.clearMask[bank]) any = true;
+  }
+  if (!any) return;
+  for (uint8_t bank = 0; bank < GPIO_BATCH_BANKS; bank++) {
+    hostOutputLatch[bank] = (hostOutputLatch[bank] | batch.setMask[bank]) & ~batch.clearMask[bank];
+    hostLastCommit.setMask[bank] = batch.setMask[bank];
+    hostLastCommit.clearMask[bank] = batch.clearMask[bank];
+    batch.setMask[bank] = 0;
+    batch.clearMask[bank] = 0;
+  }
+  hostCommitCount++;
+}
+
+void hostGpioBatchReset() {
+  for (uint8_t bank = 0; bank < GPIO_BATCH_BANKS; bank++) hostOutputLatch[bank] = 0;
+  hostCommitCount = 0;
+  hostLastCommit = HostGpioCommit();
+}
+
+uint32_t hostGpioBatchCommitCount() {
+  return hostCommitCount;
+}
+
+const HostGpioCommit& hostGpioBatchLastCommit() {
+  return hostLastCommit;
+}
+
+bool hostGpioLevel(uint8_t pin) {
+  if (pin >= 32 * GPIO_BATCH_BANKS) return false;
+  return (hostOutputLatch[pin >> 5] >> (pin & 31)) & 1u;
+}
+
+#endif
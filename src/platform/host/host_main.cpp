@@ -0,0 +1,200 @@
+// Host (Linux) entry point for the Arduino-free core (`pio run -e host -t exec`): runs the
+// step scheduler and stepper motion math against the host step timer and the output batching
+// against the host GPIO batch, times the pixel effects, and exits non-zero when a check fails.
+#if !defined(ARDUINO)
+
+#include <stdio.h>
+#include <string.h>
+
+#include <chrono>
+
+#include "core/pixel_effects.h"
+#include "core/step_scheduler.h"
+#include "core/stepper_motion.h"
+#include "platform/host/gpio_batch.h"
+#include "platform/host/step_timer.h"
+
+static uint16_t failures = 0;
+
+static void expect(bool ok, const char* what) {
+  printf("%s %s\n", ok ? "ok  " : "FAIL", what);
+  if (!ok) failures++;
+}
+
+// Every handled event is logged; event 0 re-arms itself `repeatsLeft` times, 100 us apart.
+static constexpr uint8_t FIRED_LOG_SIZE = 16;
+static constexpr uint32_t REPEAT_INTERVAL_US = 100;
+static uint8_t firedIds[FIRED_LOG_SIZE];
+static uint32_t firedAtUs[FIRED_LOG_SIZE];
+static uint8_t firedCount = 0;
+static uint8_t repeatsLeft = 0;
+static uint8_t flushCount = 0;
+
+static bool onStepEvent(uint8_t id, uint32_t nowUs, uint32_t& nextDueUs) {
+  if (firedCount < FIRED_LOG_SIZE) {
+    firedIds[firedCount] = id;
+    firedAtUs[firedCount] = nowUs;
+  }
+  firedCount++;
+  if (id != 0 || repeatsLeft == 0) return false;
+  repeatsLeft--;
+  nextDueUs = nowUs + REPEAT_INTERVAL_US;
+  return true;
+}
+
+static void onStepFlush() {
+  flushCount++;
+}
+
+static void checkStepScheduler() {
+  // Starts just below the 32-bit wrap, so due times are compared across it.
+  const uint32_t startUs = 0xFFFFFF00u;
+  hostStepTimerReset(startUs);
+  stepSchedulerBegin(onStepEvent, onStepFlush);
+
+  stepSchedulerSchedule(2, startUs + 300);
+  stepSchedulerSchedule(1, startUs + 200);
+  stepSchedulerSchedule(3, startUs + 250);
+  stepSchedulerSchedule(3, startUs + 400);
+  stepSchedulerSchedule(4, startUs + 350);
+  stepSchedulerCancel(4);
+  expect(hostStepTimerArmed() && hostStepTimerDeadlineUs() == startUs + 200, "scheduler arms for the earliest event");
+  expect(!stepSchedulerPending(4), "cancelled event leaves the queue");
+
+  hostStepTimerAdvance(1000);
+  expect(firedCount == 3 && firedIds[0] == 1 && firedIds[1] == 2 && firedIds[2] == 3,
+         "events fire in due order across the timer wrap, a moved event at its new time");
+  expect(firedAtUs[0] == startUs + 200 && firedAtUs[1] == startUs + 300 && firedAtUs[2] == startUs + 400,
+         "events fire at their due time");
+  expect(flushCount == 3, "flush runs once per timer callback");
+  expect(!hostStepTimerArmed(), "timer is disarmed once the queue is empty");
+
+  firedCount = 0;
+  repeatsLeft = 3;
+  const uint32_t firstUs = stepTimerNowUs() + 50;
+  stepSchedulerSchedule(0, firstUs);
+  stepSchedulerEnsure(0, firstUs + 10);
+  hostStepTimerAdvance(1000);
+  expect(firedCount == 4, "a re-armed event fires until its handler drops it");
+  expect(firedAtUs[0] == firstUs && firedAtUs[3] == firstUs + 3 * REPEAT_INTERVAL_US,
+         "a re-armed event keeps its interval; ensure leaves a queued event alone");
+  expect(!stepSchedulerPending(0) && !hostStepTimerArmed(), "a dropped event leaves the timer disarmed");
+}
+
+static void checkStepperMotion() {
+  // 200 full steps per revolution.
+  const uint32_t stepsPerDegQ16 = (uint32_t)((200ull << 16) / 360);
+  expect(computeStepperIntervalUs(stepsPerDegQ16, 360000, 100) == 5000, "one revolution per second is 5000 us per step");
+  expect(computeStepperIntervalUs(stepsPerDegQ16, 3600000000u, 100) == 100, "intervals are clamped to the driver minimum");
+  expect(stepperMilliDegToSteps(stepsPerDegQ16, 90000) == 50 && stepperMilliDegToSteps(stepsPerDegQ16, -90000) == -50,
+         "angles round to the nearest step in both directions");
+
+  static StepperRamp ramp;
+  const bool built = buildStepperRamp(ramp, 3200, STEPPER_STEP_DIR_MIN_INTERVAL_US, 360.0f, 720.0f, 0.0f);
+  expect(built && ramp.length > 0, "trapezoidal ramp is built");
+  bool falling = true;
+  for (uint16_t n = 1; n < ramp.length; n++) {
+    if (ramp.intervalFixed[n] > ramp.intervalFixed[n - 1]) falling = false;
+  }
+  expect(falling, "ramp intervals shrink toward full speed");
+  // 3200 steps/s at full speed: 312.5 us, in 1/16 us.
+  const uint32_t cruise = stepperRampInterval(ramp, ramp.steps);
+  expect(cruise >= 4900 && cruise <= 5100, "ramp ends at the full-speed interval");
+}
+
+static uint32_t pinMask(uint8_t pin) {
+  return 1u << (pin & 31);
+}
+
+// Same half-step pattern as the stepper coil writer: coil c is on for phases 2c-1..2c+1.
+static void writeCoils(GpioBatch& batch, const uint8_t* pins, uint8_t phase) {
+  for (uint8_t c = 0; c < 4; c++) gpioBatchWrite(batch, pins[c], ((uint8_t)(phase - 2 * c + 1) & 0x07) <= 2);
+}
+
+static void checkGpioBatch() {
+  // Coils straddle both banks.
+  static const uint8_t coilPins[4] = {4, 16, 33, 25};
+  static const uint8_t expectedOn[8] = {0x1, 0x3, 0x2, 0x6, 0x4, 0xC, 0x8, 0x9};
+  hostGpioBatchReset();
+  GpioBatch batch;
+  bool masksMatch = true;
+  bool levelsMatch = true;
+  for (uint8_t phase = 0; phase < 8; phase++) {
+    writeCoils(batch, coilPins, phase);
+    gpioBatchCommit(batch);
+    const HostGpioCommit& commit = hostGpioBatchLastCommit();
+    uint32_t setMask[GPIO_BATCH_BANKS] = {0, 0};
+    uint32_t clearMask[GPIO_BATCH_BANKS] = {0, 0};
+    for (uint8_t c = 0; c < 4; c++) {
+      const bool on = (expectedOn[phase] >> c) & 1;
+      (on ? setMask : clearMask)[coilPins[c] >> 5] |= pinMask(coilPins[c]);
+      if (hostGpioLevel(coilPins[c]) != on) levelsMatch = false;
+    }
+    for (uint8_t bank = 0; bank < GPIO_BATCH_BANKS; bank++) {
+      if (commit.setMask[bank] != setMask[bank] || commit.clearMask[bank] != clearMask[bank]) masksMatch = false;
+    }
+  }
+  expect(hostGpioBatchCommitCount() == 8, "one commit per half step");
+  expect(masksMatch, "each half step commits its set/clear masks per bank together");
+  expect(levelsMatch, "coil levels follow the half-step sequence");
+  expect(!gpioBatchPending(batch), "a commit empties the batch");
+
+  gpioBatchWrite(batch, 5, true);
+  gpioBatchWrite(batch, 5, false);
+  gpioBatchWrite(batch, 255, true);
+  gpioBatchCommit(batch);
+  const HostGpioCommit& last = hostGpioBatchLastCommit();
+  expect(last.setMask[0] == 0 && last.clearMask[0] == pinMask(5) && last.setMask[1] == 0 && last.clearMask[1] == 0,
+         "the last write to a pin wins and unassigned pins are ignored");
+  gpioBatchCommit(batch);
+  expect(hostGpioBatchCommitCount() == 9, "an empty batch commits nothing");
+}
+
+// Longest strip the pixel outputs accept (MAX_PIXELS_PER_STRIP; config.h needs Arduino).
+static constexpr uint16_t EFFECT_PIXELS = 1024;
+static constexpr uint16_t EFFECT_TIMED_FRAMES = 1000;
+
+static void checkPixelEffects() {
+  static uint8_t rgb[EFFECT_PIXELS * 3];
+  static const char* const names[PIXEL_EFFECT_COUNT] = {"solid", "chase", "gradient", "noise", "strobe", "fire"};
+  // Effect, speed, color A, color B, size.
+  uint8_t slots[PIXEL_EFFECT_SLOTS] = {0, 128, 255, 64, 0, 0, 32, 255, 15};
+
+  PixelEffectParams params;
+  PixelEffectState state = {0, 1};
+  decodePixelEffectParams(slots, params);
+  renderPixelEffect(params, state, PIXEL_EFFECT_FRAME_MS, rgb, EFFECT_PIXELS);
+  expect(params.effect == PIXEL_EFFECT_SOLID && rgb[0] == 255 && rgb[1] == 64 && rgb[2] == 0 &&
+             memcmp(rgb, rgb + 3 * (EFFECT_PIXELS - 1), 3) == 0,
+         "solid fills the strip with color A");
+
+  // Render time per frame at the fixed frame rate; the node has PIXEL_EFFECT_FRAME_MS per frame
+  // for every effect strip together.
+  bool decoded = true;
+  for (uint8_t e = 0; e < PIXEL_EFFECT_COUNT; e++) {
+    slots[0] = (uint8_t)((e * 256 + 128) / PIXEL_EFFECT_COUNT);
+    decodePixelEffectParams(slots, params);
+    if (params.effect != e) decoded = false;
+    state.phase = 0;
+    state.seed = 1;
+    const auto start = std::chrono::steady_clock::now();
+    for (uint16_t f = 0; f < EFFECT_TIMED_FRAMES; f++) {
+      renderPixelEffect(params, state, PIXEL_EFFECT_FRAME_MS, rgb, EFFECT_PIXELS);
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    const double usPerFrame = std::chrono::duration<double, std::micro>(elapsed).count() / EFFECT_TIMED_FRAMES;
+    printf("     %-8s %u px: %.1f us/frame\n", names[e], (unsigned)EFFECT_PIXELS, usPerFrame);
+  }
+  expect(decoded, "each effect slot range decodes to its effect");
+}
+
+int main() {
+  checkStepScheduler();
+  checkStepperMotion();
+  checkGpioBatch();
+  checkPixelEffects();
+  printf("%u failed\n", (unsigned)failures);
+  return failures == 0 ? 0 : 1;
+}
+
+#endif
@@ -0,0 +1,56 @@
+#include "platform/step_timer.h"
+
+#if !defined(ARDUINO)
+
+#include "platform/host/step_timer.h"
+
+static StepTimerCallback stepTimerCallback = nullptr;
+static uint32_t hostNowUs = 0;
+static uint32_t hostDeadlineUs = 0;
+static bool hostArmed = false;
+
+bool stepTimerBegin(StepTimerCallback callback) {
+  stepTimerCallback = callback;
+  return true;
+}
+
+void stepTimerArm(uint32_t delayUs) {
+  hostDeadlineUs = hostNowUs + delayUs;
+  hostArmed = true;
+}
+
+void stepTimerDisarm() {
+  hostArmed = false;
+}
+
+uint32_t stepTimerNowUs() {
+  return hostNowUs;
+}
+
+void stepTimerLock() {}
+void stepTimerUnlock() {}
+
+void hostStepTimerReset(uint32_t nowUs) {
+  hostNowUs = nowUs;
+  hostArmed = false;
+}
+
+void hostStepTimerAdvance(uint32_t deltaUs) {
+  const uint32_t endUs = hostNowUs + deltaUs;
+  while (hostArmed && (int32_t)(endUs - hostDeadlineUs) >= 0) {
+    hostNowUs = hostDeadlineUs;
+    hostArmed = false;
+    if (stepTimerCallback) stepTimerCallback();
+  }
+  hostNowUs = endUs;
+}
+
+bool hostStepTimerArmed() {
+  return hostArmed;
+}
+
+uint32_t hostStepTimerDeadlineUs() {
+  return hostDeadlineUs;
+}
+
+#endif
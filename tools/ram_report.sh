@@ -0,0 +1,21 @@
+#!/bin/sh
+# Builds each PlatformIO environment (one per feature-flag combination) and prints the
+# linker's static RAM/flash usage side by side. Usage: tools/ram_report.sh [env ...]
+# The per-table breakdown (config, snapshot, runtime arena) and the pixel frame memory
+# (arena use and peak, DMA frame, free heap) are printed on the serial console at boot and
+# shown on the web status page.
+set -e
+cd "$(dirname "$0")/.."
+
+envs="$*"
+if [ -z "$envs" ]; then
+  # The host env builds a Linux program, not firmware.
+  envs=$(sed -n 's/^\[env:\(.*\)\]$/\1/p' platformio.ini | grep -v '^host$')
+fi
+
+for env in $envs; do
+  out=$(pio run -e "$env" 2>&1) || { echo "$env: build failed"; echo "$out" | tail -n 20; exit 1; }
+  ram=$(echo "$out" | grep -E '^RAM:' | sed 's/^RAM: *//')
+  flash=$(echo "$out" | grep -E '^Flash:' | sed 's/^Flash: *//')
+  printf '%-24s RAM %s\n%-24s Flash %s\n' "$env" "$ram" "" "$flash"
+done